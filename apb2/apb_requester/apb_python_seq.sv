@@ -1,16 +1,62 @@
 // Module: APB Python Sequence
 // Filename: apb_python_seq.sv
 
+// Python request record - must match APB_REQUEST_FIELDS in
+// sim/dpi_bridge/plugins/apb/apb_request.h (same fields, same order)
+typedef struct packed {
+  bit        is_write;
+  bit [63:0] addr;
+  bit [63:0] data;
+  bit [7:0]  strobe;
+  bit [2:0]  prot;
+  bit [31:0] delay;
+  bit [3:0]  op;
+  bit [63:0] mask;
+  bit [31:0] timeout;
+} apb_py_req_t;
+
+// Values of apb_py_req_t.op - must match APB_OP_* in apb_request.h
+typedef enum bit [3:0] {
+  APB_PY_OP_XFER        = 0,
+  APB_PY_OP_WAIT_CLOCKS = 1,
+  APB_PY_OP_WAIT_RESET  = 2,
+  APB_PY_OP_POLL        = 3
+} apb_py_op_e;
+
+// Status passed to dpi_op_done - must match APB_OP_STATUS_* in apb_request.h
+typedef enum int {
+  APB_PY_OP_DONE        = 0,
+  APB_PY_OP_TIMEOUT     = 1,
+  APB_PY_OP_UNSUPPORTED = 2
+} apb_py_op_status_e;
+
 import "DPI-C" context function int dpi_init_python();
 import "DPI-C" context function void dpi_finalize_python();
-import "DPI-C" context function int dpi_get_transaction(input longint time_ps, output int is_write, output int addr, output int data);
-import "DPI-C" context function void dpi_send_read_data(input longint time_ps, input int data);
+import "DPI-C" context function int dpi_load_test(input string test_name);
+import "DPI-C" context function int dpi_get_transaction(input longint sim_time, output int is_write, output int addr, output int data);
+import "DPI-C" context function int dpi_get_request(input longint sim_time, output apb_py_req_t request);
+import "DPI-C" context function int dpi_get_request_width();
+import "DPI-C" context function void dpi_send_read_data(input longint sim_time, input int data);
+import "DPI-C" context function void dpi_op_done(input longint sim_time, input int status, input int data);
+import "DPI-C" context function int dpi_profile_start(input longint sim_time);
+import "DPI-C" context function void dpi_profile_stop(input longint sim_time);
 
 class apb_python_seq extends apb_base_seq;
   `uvm_object_utils(apb_python_seq)
 
+  // Python test to run; empty = default (APB_TEST environment variable)
+  string test_name;
+
+  // Clock and reset for the opcodes that run in SV (wait, poll)
+  virtual apb_if vif;
+
   extern function new(string name = "apb_python_seq");
   extern task body();
+  extern task do_xfer(apb_py_req_t py_req);
+  extern task do_wait_reset(apb_py_req_t py_req);
+  extern task do_poll(apb_py_req_t py_req);
+  extern function bit get_vif();
+  extern function void check_width(apb_py_req_t py_req);
 
 endclass: apb_python_seq
 
@@ -19,44 +65,184 @@ function apb_python_seq::new(string name = "apb_python_seq");
 endfunction
 
 task apb_python_seq::body();
-  int is_write;
-  int addr;
-  int data;
+  apb_py_req_t py_req;
   int valid;
+  bit profile;
 
   if (dpi_init_python() != 0) begin
     `uvm_error("APB_PYTHON_SEQ", "Failed to initialize Python")
     return;
   end
 
+  if (test_name != "" && dpi_load_test(test_name) != 0) begin
+    `uvm_error("APB_PYTHON_SEQ", $sformatf("Failed to load Python test '%s'", test_name))
+    dpi_finalize_python();
+    return;
+  end
+
+  if ($bits(apb_py_req_t) != dpi_get_request_width()) begin
+    `uvm_fatal("APB_PYTHON_SEQ", $sformatf("apb_py_req_t is %0d bits, C bridge record is %0d bits",
+                                           $bits(apb_py_req_t), dpi_get_request_width()))
+  end
+
+  // +DPI_PROFILE: sample the Python side of this sequence
+  profile = $test$plusargs("DPI_PROFILE");
+  if (profile && dpi_profile_start($time) != 0) begin
+    `uvm_warning("APB_PYTHON_SEQ", "Failed to start Python profiler")
+    profile = 0;
+  end
+
   forever begin
-    valid = dpi_get_transaction($time, is_write, addr, data);
+    valid = dpi_get_request($time, py_req);
     if (valid == 0) break;
 
+    // Opcodes other than XFER run here without calling Python
+    case (py_req.op)
+      APB_PY_OP_XFER: do_xfer(py_req);
+      APB_PY_OP_WAIT_CLOCKS: begin
+        if (get_vif()) begin
+          repeat (py_req.delay) @(posedge vif.PCLK);
+          dpi_op_done($time, APB_PY_OP_DONE, 0);
+        end else begin
+          dpi_op_done($time, APB_PY_OP_UNSUPPORTED, 0);
+        end
+      end
+      APB_PY_OP_WAIT_RESET: do_wait_reset(py_req);
+      APB_PY_OP_POLL: do_poll(py_req);
+      default: begin
+        `uvm_warning("APB_PYTHON_SEQ", $sformatf("Unknown request opcode %0d", py_req.op))
+        dpi_op_done($time, APB_PY_OP_UNSUPPORTED, 0);
+      end
+    endcase
+  end
+
+  if (profile) dpi_profile_stop($time);
+
+  dpi_finalize_python();
+endtask
+
+// One APB transfer; read data goes back to Python
+task apb_python_seq::do_xfer(apb_py_req_t py_req);
+  check_width(py_req);
+
+  req = apb_xtn::type_id::create("req");
+  start_item(req);
+  
+  req.apb_address  = py_req.addr;
+  req.apb_prot     = py_req.prot;
+  req.apb_en_delay = py_req.delay;
+  if (py_req.is_write) begin
+    req.apb_wr_data = py_req.data;
+    req.apb_strobe  = py_req.strobe;
+    req.apb_rd_wr = apb_xtn::APB_WRITE;
+  end else begin
+    req.apb_rd_wr = apb_xtn::APB_READ;
+  end
+  
+  // Randomize other fields if necessary, or just finish
+  // assert(req.randomize()); // Might overwrite our values if not careful with constraints
+  // Instead of full randomize, we set specific fields. 
+  // If there are other required fields, we should handle them.
+  // Assuming psel, penable etc are handled by driver.
+  
+  finish_item(req);
+
+  if (!py_req.is_write) begin
+    dpi_send_read_data($time, req.apb_rd_data);
+  end
+endtask
+
+// Wait until PRESETn is deasserted, at most `timeout` cycles (0 = no limit)
+task apb_python_seq::do_wait_reset(apb_py_req_t py_req);
+  bit timed_out;
+
+  if (!get_vif()) begin
+    dpi_op_done($time, APB_PY_OP_UNSUPPORTED, 0);
+    return;
+  end
+
+  fork begin
+    fork
+      wait (vif.PRESETn === 1'b1);
+      if (py_req.timeout != 0) begin
+        repeat (py_req.timeout) @(posedge vif.PCLK);
+        timed_out = 1;
+      end else begin
+        wait (0);
+      end
+    join_any
+    disable fork;
+  end join
+
+  dpi_op_done($time, timed_out ? APB_PY_OP_TIMEOUT : APB_PY_OP_DONE, 0);
+endtask
+
+// Read `addr` until (rdata & mask) == (data & mask), `delay` idle cycles
+// between reads, at most `timeout` cycles (0 = no limit)
+task apb_python_seq::do_poll(apb_py_req_t py_req);
+  int unsigned cycles;
+  process counter;
+  bit [63:0] rdata;
+  bit matched;
+
+  if (!get_vif()) begin
+    dpi_op_done($time, APB_PY_OP_UNSUPPORTED, 0);
+    return;
+  end
+
+  check_width(py_req);
+
+  // Count cycles in the background; a read in flight is never cut short
+  fork begin
+    counter = process::self();
+    forever begin
+      @(posedge vif.PCLK);
+      cycles++;
+    end
+  end join_none
+  wait (counter != null);
+
+  forever begin
     req = apb_xtn::type_id::create("req");
     start_item(req);
-    
-    if (is_write) begin
-      req.apb_address = addr;
-      req.apb_wr_data = data;
-      req.apb_rd_wr = apb_xtn::APB_WRITE;
-    end else begin
-      req.apb_address = addr;
-      req.apb_rd_wr = apb_xtn::APB_READ;
-    end
-    
-    // Randomize other fields if necessary, or just finish
-    // assert(req.randomize()); // Might overwrite our values if not careful with constraints
-    // Instead of full randomize, we set specific fields. 
-    // If there are other required fields, we should handle them.
-    // Assuming psel, penable etc are handled by driver.
-    
+    req.apb_address  = py_req.addr;
+    req.apb_prot     = py_req.prot;
+    req.apb_rd_wr    = apb_xtn::APB_READ;
+    req.apb_en_delay = 0;
     finish_item(req);
 
-    if (!is_write) begin
-      dpi_send_read_data($time, req.apb_rd_data);
-    end
+    rdata = req.apb_rd_data;
+    matched = (rdata & py_req.mask) == (py_req.data & py_req.mask);
+    if (matched || (py_req.timeout != 0 && cycles >= py_req.timeout)) break;
+
+    repeat (py_req.delay) @(posedge vif.PCLK);
   end
 
-  dpi_finalize_python();
+  counter.kill();
+  dpi_op_done($time, matched ? APB_PY_OP_DONE : APB_PY_OP_TIMEOUT, rdata);
 endtask
+
+// Looks up the APB interface set by the testbench top, once
+function bit apb_python_seq::get_vif();
+  if (vif == null && !uvm_config_db#(virtual apb_if)::get(null, get_full_name(), "apb_if", vif)) begin
+    `uvm_error("APB_PYTHON_SEQ", "No apb_if in the configuration database, cannot run wait/poll requests")
+  end
+  return vif != null;
+endfunction
+
+// The record carries 64-bit addr/data/mask and 8 strobe bits, apb_xtn and
+// the bus only 32 data bits and 4 byte lanes
+function void apb_python_seq::check_width(apb_py_req_t py_req);
+  if (py_req.addr[63:32] != 0) begin
+    `uvm_error("APB_PYTHON_SEQ", $sformatf("Address 0x%0h does not fit the 32-bit APB bus", py_req.addr))
+  end
+  if (py_req.data[63:32] != 0) begin
+    `uvm_error("APB_PYTHON_SEQ", $sformatf("Data 0x%0h does not fit the 32-bit APB bus", py_req.data))
+  end
+  if (py_req.mask[63:32] != 0) begin
+    `uvm_error("APB_PYTHON_SEQ", $sformatf("Mask 0x%0h does not fit the 32-bit APB bus", py_req.mask))
+  end
+  if (py_req.strobe[7:4] != 0) begin
+    `uvm_error("APB_PYTHON_SEQ", $sformatf("Strobe 0x%0h does not fit the 4 APB byte lanes", py_req.strobe))
+  end
+endfunction
@@ -8,7 +8,9 @@ package apb_test_pkg;
 
     // Import DPI-C functions
     import "DPI-C" context function int dpi_init_python();
+    import "DPI-C" context function void dpi_finalize_python();
     import "DPI-C" context function void dpi_send_object(input string tag, input string object_str);
+    import "DPI-C" context function void dpi_send_timed_object(input longint sim_time, input string tag, input string object_str);
 
   `include "apb_base_test.svh"
   `include "apb_init_test.svh"
@@ -14,14 +14,32 @@
  *    - Calls the `init()` function of every plugin (APB, Generic, etc.).
  *    - This MUST be called in your SV `initial` block or `end_of_elaboration_phase`.
  * 
+ *    - With DPI_WARM_SOCKET set, connects to a pre-initialized warm worker
+ *      instead (see `dpi_bridge/core/dpi_warm.c`).
+ * 
  * 2. `dpi_finalize_python()`:
  *    - Shuts everything down cleanly.
  *    - Ensures all Python files are closed and memory is freed.
+ *    - With DPI_MEM_INTERVAL set, first prints the memory accounting report
+ *      (see `dpi_bridge/core/dpi_mem.c`).
  *    - This MUST be called in your SV `final` block or `extract_phase`.
+ * 
+ * 3. Sessions (init/finalize are reference counted):
+ *    - Every `dpi_init_python()` must be paired with a `dpi_finalize_python()`.
+ *    - Only the FIRST init boots Python; only the LAST finalize shuts it down.
+ *    - A finalize that is not the last one just resets plugin state, so the
+ *      next sequence starts clean without a Py_Finalize/Py_Initialize cycle.
+ *    - Hold a session for the whole test (e.g. init in `start_of_simulation_phase`,
+ *      finalize in `final_phase`) to run many Python tests in one elaboration;
+ *      switch tests with `dpi_load_test(name)`.
  */
 
 #include "dpi_bridge/core/dpi_core.h"
+#include "dpi_bridge/core/dpi_mem.h"
 #include "dpi_bridge/core/dpi_registry.h"
+#include "dpi_bridge/core/dpi_profile.h"
+#include "dpi_bridge/core/dpi_trace.h"
+#include "dpi_bridge/core/dpi_warm.h"
 #include "dpi_bridge/plugins/apb/apb_plugin.h"
 #include "dpi_bridge/plugins/generic/generic_plugin.h"
 #include "svdpi.h"
@@ -29,17 +47,26 @@
 // Global registry to track all active plugins
 static dpi_registry_t *g_registry = NULL;
 
+// Number of dpi_init_python() calls not yet matched by dpi_finalize_python()
+static int g_session_refs = 0;
+
 /**
- * dpi_init_python()
+ * dpi_bridge_init()
  * 
  * Description:
  *   Initializes the Python interpreter and all registered DPI plugins.
- *   This is the first function called by SystemVerilog.
  * 
  * Returns:
  *   0 on success, 1 on failure.
  */
-int dpi_init_python() {
+static int dpi_bridge_init(void) {
+    int status;
+
+    // Warm start: Python already runs in a forked worker, nothing to boot here
+    if (dpi_warm_requested()) {
+        return dpi_warm_connect() == DPI_SUCCESS ? 0 : 1;
+    }
+
     // Initialize Python interpreter
     if (dpi_core_init_python() != DPI_SUCCESS) {
         return 1;
@@ -54,34 +81,124 @@ int dpi_init_python() {
 
     // Initialize APB plugin
     // TODO: In future, iterate through a list of plugins to initialize dynamically
-    if (apb_init() != DPI_SUCCESS) {
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_PLUGIN, "apb_init", DPI_TRACE_TIME_LAST);
+    status = apb_init();
+    DPI_TRACE_END(DPI_TRACE_CAT_PLUGIN, "apb_init", DPI_TRACE_TIME_LAST);
+    if (status != DPI_SUCCESS) {
         dpi_registry_destroy(g_registry);
         dpi_core_finalize_python();
         return 1;
     }
 
     // Initialize Generic plugin
-    if (generic_init() != DPI_SUCCESS) {
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_PLUGIN, "generic_init", DPI_TRACE_TIME_LAST);
+    status = generic_init();
+    DPI_TRACE_END(DPI_TRACE_CAT_PLUGIN, "generic_init", DPI_TRACE_TIME_LAST);
+    if (status != DPI_SUCCESS) {
         dpi_registry_destroy(g_registry);
         dpi_core_finalize_python();
         return 1;
     }
 
+    // Memory accounting (optional, DPI_MEM_INTERVAL); plugins registered their domains
+    dpi_mem_init();
+
     DPI_LOG_INFO("DPI Bridge initialized successfully");
     return 0;
 }
 
+/**
+ * dpi_init_python()
+ * 
+ * Description:
+ *   Initializes the Python interpreter and all registered DPI plugins.
+ *   This is the first function called by SystemVerilog.
+ *   Set DPI_TRACE=<file.json> to record a timeline of every bridge crossing.
+ * 
+ * Returns:
+ *   0 on success, 1 on failure.
+ */
+int dpi_init_python() {
+    int status = 0;
+
+    dpi_trace_init();
+
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_DPI, "dpi_init_python", DPI_TRACE_TIME_LAST);
+    if (g_session_refs == 0) {
+        status = dpi_bridge_init();
+    }
+    if (status == 0) {
+        g_session_refs++;
+        DPI_LOG_INFO("DPI Bridge session references: %d", g_session_refs);
+    }
+    DPI_TRACE_END(DPI_TRACE_CAT_DPI, "dpi_init_python", DPI_TRACE_TIME_LAST);
+
+    return status;
+}
+
+/**
+ * dpi_bridge_reset()
+ * 
+ * Description:
+ *   Returns all plugins to their just-initialized state while keeping the
+ *   interpreter and loaded modules alive. Used between tests of a session.
+ */
+static void dpi_bridge_reset(void) {
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_PLUGIN, "dpi_bridge_reset", DPI_TRACE_TIME_LAST);
+
+    if (dpi_warm_active()) {
+        dpi_warm_load_test("");
+    } else {
+        // Plugins are reset directly, like apb_init()/generic_init() above
+        apb_reset();
+        generic_reset();
+    }
+
+    DPI_TRACE_END(DPI_TRACE_CAT_PLUGIN, "dpi_bridge_reset", DPI_TRACE_TIME_LAST);
+    DPI_LOG_INFO("DPI Bridge reset, session references: %d", g_session_refs);
+}
+
 /**
  * dpi_finalize_python()
  * 
  * Description:
- *   Cleans up all resources: finalizes plugins, destroys registry, and
- *   shuts down the Python interpreter. Called at end of simulation.
+ *   Releases one session reference. The last one cleans up all resources:
+ *   finalizes plugins, destroys registry, and shuts down the Python
+ *   interpreter. Earlier ones only reset plugin state.
  */
 void dpi_finalize_python() {
+    if (g_session_refs == 0) {
+        return;
+    }
+
+    // Plugins may have let the GIL go to helper threads; take it back
+    dpi_core_enter();
+
+    if (--g_session_refs > 0) {
+        dpi_bridge_reset();
+        dpi_core_leave();
+        return;
+    }
+
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_DPI, "dpi_finalize_python", DPI_TRACE_TIME_LAST);
+
+    // Close any profiler window left open by SV
+    dpi_profile_shutdown();
+
+    // Memory report, while the plugins' Python objects are still alive
+    dpi_mem_finalize();
+
+    // Release the warm worker (no-op when running a local interpreter)
+    dpi_warm_disconnect();
+
     // Cleanup APB plugin
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_PLUGIN, "apb_cleanup", DPI_TRACE_TIME_LAST);
     apb_cleanup();
+    DPI_TRACE_END(DPI_TRACE_CAT_PLUGIN, "apb_cleanup", DPI_TRACE_TIME_LAST);
+
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_PLUGIN, "generic_cleanup", DPI_TRACE_TIME_LAST);
     generic_cleanup();
+    DPI_TRACE_END(DPI_TRACE_CAT_PLUGIN, "generic_cleanup", DPI_TRACE_TIME_LAST);
 
     // Cleanup registry
     if (g_registry != NULL) {
@@ -92,6 +209,10 @@ void dpi_finalize_python() {
 
     // Finalize Python
     dpi_core_finalize_python();
+
+    // Timeline is written last so it covers the whole teardown
+    DPI_TRACE_END(DPI_TRACE_CAT_DPI, "dpi_finalize_python", DPI_TRACE_TIME_LAST);
+    dpi_trace_finalize();
     
     DPI_LOG_INFO("DPI Bridge finalized");
 }
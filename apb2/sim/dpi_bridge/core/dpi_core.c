@@ -21,13 +21,28 @@
  * 3. sys.path:
  *    - Just like `+incdir+` in Verilog.
  *    - We explicitly add `./sim` and `./plugins` to `sys.path` so Python can `import` your scripts.
+ * 
+ * 4. The GIL (Global Interpreter Lock):
+ *    - Only one thread at a time may run Python. By default the simulator
+ *      thread simply keeps it for the whole run.
+ *    - A plugin that runs Python on a helper thread (the APB prefetch producer)
+ *      calls `dpi_core_enable_threads()`. From then on the simulator thread
+ *      gives the GIL back whenever control returns to SV, and every DPI entry
+ *      point that touches Python brackets its work with `dpi_core_enter()` /
+ *      `dpi_core_leave()`.
  */
 
 #include "dpi_core.h"
+#include "dpi_trace.h"
 #include <stdio.h>
 
 static int python_initialized = 0;
 
+// Simulator thread GIL handoff (see dpi_core_enter/dpi_core_leave)
+static int threads_enabled = 0;
+static int enter_depth = 0;
+static PyThreadState *saved_tstate = NULL;
+
 /**
  * dpi_core_init_python()
  * 
@@ -66,6 +81,14 @@ int dpi_core_init_python(void) {
  *   Shuts down the Python interpreter and releases resources.
  */
 void dpi_core_finalize_python(void) {
+    // Py_Finalize() must run with the GIL held by this thread
+    if (saved_tstate != NULL) {
+        PyEval_RestoreThread(saved_tstate);
+        saved_tstate = NULL;
+    }
+    threads_enabled = 0;
+    enter_depth = 0;
+
     if (!python_initialized) {
         return;
     }
@@ -164,7 +187,10 @@ PyObject* dpi_core_call_function(PyObject *func, PyObject *args) {
         return NULL;
     }
 
+    const char *name = dpi_trace_enabled ? PyEval_GetFuncName(func) : NULL;
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_PYTHON, name, DPI_TRACE_TIME_LAST);
     PyObject *result = PyObject_CallObject(func, args);
+    DPI_TRACE_END(DPI_TRACE_CAT_PYTHON, name, DPI_TRACE_TIME_LAST);
     if (result == NULL) {
         PyErr_Print(); // Critical: Print traceback if Python code raises exception
         DPI_LOG_ERROR("Function call failed");
@@ -172,3 +198,43 @@ PyObject* dpi_core_call_function(PyObject *func, PyObject *args) {
 
     return result;
 }
+
+/**
+ * dpi_core_enable_threads()
+ * 
+ * Description:
+ *   Lets helper threads run Python while the simulator is busy in SV: from
+ *   now on the simulator thread releases the GIL at every dpi_core_leave().
+ *   Must be called by the simulator thread between dpi_core_enter() and
+ *   dpi_core_leave(). Stays on until dpi_core_finalize_python().
+ */
+void dpi_core_enable_threads(void) {
+    threads_enabled = 1;
+}
+
+/**
+ * dpi_core_enter()
+ * 
+ * Description:
+ *   Called by the simulator thread at the start of a DPI entry point that
+ *   uses Python. Takes the GIL back if it was given away. Calls may nest.
+ */
+void dpi_core_enter(void) {
+    if (enter_depth++ == 0 && saved_tstate != NULL) {
+        PyEval_RestoreThread(saved_tstate);
+        saved_tstate = NULL;
+    }
+}
+
+/**
+ * dpi_core_leave()
+ * 
+ * Description:
+ *   Matches dpi_core_enter(). When leaving the outermost entry point with
+ *   helper threads enabled, releases the GIL until the next DPI call.
+ */
+void dpi_core_leave(void) {
+    if (enter_depth > 0 && --enter_depth == 0 && threads_enabled && python_initialized) {
+        saved_tstate = PyEval_SaveThread();
+    }
+}
@@ -16,4 +16,9 @@ PyObject* dpi_core_get_function(PyObject *module, const char *func_name);
 // Utility: Call Python function with arguments
 PyObject* dpi_core_call_function(PyObject *func, PyObject *args);
 
+// Simulator thread GIL handoff, for plugins that run Python on helper threads
+void dpi_core_enable_threads(void);
+void dpi_core_enter(void);
+void dpi_core_leave(void);
+
 #endif // DPI_CORE_H
@@ -0,0 +1,631 @@
+/*
+ * DPI Memory Accounting - The "Power Monitor" for Python
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * In a multi-day soak run, the embedded interpreter can slowly grow: a test
+ * that keeps every transaction, a parser that caches results, a reference the
+ * C marshalling code forgot to drop. `top` only shows that the simulator got
+ * bigger. This file samples the interpreter from the inside at fixed sim-time
+ * intervals, like a monitor sampling supply current, and says WHO grew.
+ *
+ * Each sample records:
+ *   - the process RSS (resident memory, from /proc/self/statm),
+ *   - the number of live Python objects tracked by the garbage collector,
+ *   - Python heap bytes per domain, using `tracemalloc`. A domain is a
+ *     plugin's Python directory (apb -> tests/, generic -> parsers/, registered
+ *     with dpi_mem_add_domain()). Two more domains collect the rest:
+ *       python - allocations made by any other Python file (stdlib, ...)
+ *       c      - allocations with no Python frame, i.e. made by the C bridge
+ *                itself (PyLong_From..., tuples, ...); growth here usually
+ *                means a missing Py_DECREF.
+ *
+ * How to use:
+ *   DPI_MEM_INTERVAL=1000000 sim.py ...    # sample every 1000000 sim time units
+ *
+ * Optional:
+ *   DPI_MEM_WARN_MB=256     warn each time RSS grows by another 256 MB over the
+ *                           first sample (0 = never)
+ *   DPI_MEM_FRAMES=1        tracemalloc frames per allocation; 0 = RSS and
+ *                           object counts only (no per-allocation overhead)
+ *   DPI_MEM_TOP=10          allocation sites / object types in the final report
+ *   DPI_MEM_OUT=mem.csv     also write every sample as a CSV line
+ *
+ * The first sample is the baseline. `dpi_finalize_python()` prints the
+ * start/peak/end figures, growth per domain, and the allocation sites
+ * (file:line) and object types that grew the most.
+ *
+ * Overhead:
+ *   Samples are taken at DPI entry points, so nothing runs between them.
+ *   tracemalloc, however, hooks every Python allocation while it is on, which
+ *   can make allocation-heavy Python code several times slower; use
+ *   DPI_MEM_FRAMES=0 to watch RSS and object counts only (no measurable
+ *   cost). A sample walks all traced blocks (roughly 10 us per live block)
+ *   and all objects, so keep the interval coarse.
+ */
+
+#include "dpi_mem.h"
+#include "dpi_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+
+#define MEM_MAX_BUCKETS     10
+#define MEM_BUCKET_C        0       // no Python frame: the C bridge
+#define MEM_BUCKET_PYTHON   1       // any Python file outside the domains
+#define MEM_DEFAULT_WARN_MB 256
+#define MEM_DEFAULT_FRAMES  1
+#define MEM_DEFAULT_TOP     10
+
+// One attribution domain and its traced Python heap bytes
+typedef struct {
+    char name[32];
+    char path[PATH_MAX];        // absolute directory, "" for the fixed buckets
+    size_t path_len;
+    uint64_t bytes;
+    uint64_t start_bytes;
+} mem_bucket_t;
+
+typedef struct {
+    dpi_time_t interval;
+    int frames;                 // tracemalloc frames, 0 = not tracing
+    uint64_t warn_bytes;
+    int top;
+    FILE *out;
+
+    PyObject *gc;
+    PyObject *tracemalloc;      // NULL when not tracing
+    PyObject *baseline;         // snapshot of the first sample
+
+    mem_bucket_t buckets[MEM_MAX_BUCKETS];
+    int num_buckets;
+
+    uint64_t samples;
+    dpi_time_t first_time;
+    dpi_time_t last_time;
+    uint64_t rss_start, rss_peak, rss_last;
+    uint64_t traced_start, traced_last;
+    Py_ssize_t objects_start, objects_last;
+    uint64_t next_warn;         // RSS growth that raises the next warning
+} mem_state_t;
+
+static mem_state_t mem = {
+    .buckets = {{"c", "", 0, 0, 0}, {"python", "", 0, 0, 0}},
+    .num_buckets = 2,
+};
+
+int dpi_mem_enabled = 0;
+dpi_time_t dpi_mem_next_sample = 0;
+
+/**
+ * dpi_mem_add_domain()
+ *
+ * Description:
+ *   Registers a plugin's Python directory. Allocations whose innermost
+ *   Python frame is in a file under `path` are counted for `name`.
+ *   May be called whether or not accounting is enabled.
+ *
+ * Args:
+ *   name: Domain name shown in the report (e.g. "apb")
+ *   path: Directory, relative to the working directory or absolute
+ */
+void dpi_mem_add_domain(const char *name, const char *path) {
+    char resolved[PATH_MAX];
+
+    if (realpath(path, resolved) == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < mem.num_buckets; i++) {
+        if (strcmp(mem.buckets[i].name, name) == 0) {
+            return;
+        }
+    }
+    if (mem.num_buckets == MEM_MAX_BUCKETS) {
+        DPI_LOG_ERROR("Too many memory domains, '%s' counted as python", name);
+        return;
+    }
+
+    mem_bucket_t *b = &mem.buckets[mem.num_buckets++];
+    memset(b, 0, sizeof(*b));
+    snprintf(b->name, sizeof(b->name), "%s", name);
+    snprintf(b->path, sizeof(b->path), "%s", resolved);
+    b->path_len = strlen(b->path);
+}
+
+/**
+ * mem_rss_bytes()
+ *
+ * Description:
+ *   Returns the resident set size of the process, or 0 if unavailable.
+ */
+static uint64_t mem_rss_bytes(void) {
+    unsigned long size, resident;
+    FILE *fp = fopen("/proc/self/statm", "r");
+
+    if (fp == NULL) {
+        return 0;
+    }
+    int n = fscanf(fp, "%lu %lu", &size, &resident);
+    fclose(fp);
+
+    return n == 2 ? (uint64_t)resident * (uint64_t)sysconf(_SC_PAGESIZE) : 0;
+}
+
+/**
+ * mem_gc_objects()
+ *
+ * Description:
+ *   Returns the number of live objects tracked by the garbage collector
+ *   (containers: instances, dicts, lists, ...), or -1 on failure.
+ */
+static Py_ssize_t mem_gc_objects(void) {
+    PyObject *objects = PyObject_CallMethod(mem.gc, "get_objects", NULL);
+    if (objects == NULL) {
+        PyErr_Clear();
+        return -1;
+    }
+    Py_ssize_t count = PyList_GET_SIZE(objects);
+    Py_DECREF(objects);
+    return count;
+}
+
+/**
+ * mem_bucket_of()
+ *
+ * Description:
+ *   Maps the file of an allocation's innermost frame to a bucket.
+ */
+static int mem_bucket_of(const char *filename) {
+    char resolved[PATH_MAX];
+
+    if (strcmp(filename, "<unknown>") == 0) {
+        return MEM_BUCKET_C;
+    }
+    if (mem.num_buckets > 2 && realpath(filename, resolved) != NULL) {
+        for (int i = 2; i < mem.num_buckets; i++) {
+            mem_bucket_t *b = &mem.buckets[i];
+            if (strncmp(resolved, b->path, b->path_len) == 0 && resolved[b->path_len] == '/') {
+                return i;
+            }
+        }
+    }
+    return MEM_BUCKET_PYTHON;
+}
+
+/**
+ * mem_filter_snapshot()
+ *
+ * Description:
+ *   Drops tracemalloc's own allocations (e.g. the baseline snapshot) from a
+ *   snapshot. Costly on large snapshots, so only used for the final report;
+ *   samples skip tracemalloc's file while attributing instead.
+ *
+ * Returns:
+ *   New reference to the filtered snapshot (the input on failure).
+ */
+static PyObject* mem_filter_snapshot(PyObject *snapshot) {
+    PyObject *filtered = NULL;
+    PyObject *file = PyObject_GetAttrString(mem.tracemalloc, "__file__");
+    PyObject *filter = file ? PyObject_CallMethod(mem.tracemalloc, "Filter", "OO", Py_False, file) : NULL;
+    if (filter != NULL) {
+        filtered = PyObject_CallMethod(snapshot, "filter_traces", "([O])", filter);
+    }
+    Py_XDECREF(filter);
+    Py_XDECREF(file);
+
+    if (filtered == NULL) {
+        PyErr_Clear();
+        Py_INCREF(snapshot);
+        return snapshot;
+    }
+    return filtered;
+}
+
+/**
+ * mem_attribute()
+ *
+ * Description:
+ *   Sums the traced bytes of a snapshot per bucket.
+ *
+ * Returns:
+ *   Total traced bytes in the snapshot.
+ */
+static uint64_t mem_attribute(PyObject *snapshot) {
+    uint64_t total = 0;
+    const char *own_file = NULL;
+
+    for (int i = 0; i < mem.num_buckets; i++) {
+        mem.buckets[i].bytes = 0;
+    }
+
+    PyObject *own = PyObject_GetAttrString(mem.tracemalloc, "__file__");
+    if (own != NULL) {
+        own_file = PyUnicode_AsUTF8(own);
+    }
+    PyErr_Clear();
+
+    PyObject *stats = PyObject_CallMethod(snapshot, "statistics", "s", "filename");
+    if (stats == NULL) {
+        PyErr_Print();
+        Py_XDECREF(own);
+        return 0;
+    }
+
+    Py_ssize_t n = PyList_GET_SIZE(stats);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        PyObject *stat = PyList_GET_ITEM(stats, i);
+        PyObject *size = PyObject_GetAttrString(stat, "size");
+        PyObject *traceback = PyObject_GetAttrString(stat, "traceback");
+        PyObject *frame = traceback ? PySequence_GetItem(traceback, 0) : NULL;
+        PyObject *filename = frame ? PyObject_GetAttrString(frame, "filename") : NULL;
+        const char *file = filename ? PyUnicode_AsUTF8(filename) : NULL;
+
+        if (size != NULL && file != NULL && (own_file == NULL || strcmp(file, own_file) != 0)) {
+            uint64_t bytes = PyLong_AsUnsignedLongLong(size);
+            mem.buckets[mem_bucket_of(file)].bytes += bytes;
+            total += bytes;
+        }
+        PyErr_Clear();
+
+        Py_XDECREF(filename);
+        Py_XDECREF(frame);
+        Py_XDECREF(traceback);
+        Py_XDECREF(size);
+    }
+    Py_DECREF(stats);
+    Py_XDECREF(own);
+    return total;
+}
+
+/**
+ * mem_write_csv()
+ *
+ * Description:
+ *   Appends the current sample to DPI_MEM_OUT (header before the first one).
+ */
+static void mem_write_csv(dpi_time_t sim_time) {
+    if (mem.out == NULL) {
+        return;
+    }
+
+    if (mem.samples == 1) {
+        fprintf(mem.out, "sim_time,rss_kb,gc_objects,traced_kb");
+        for (int i = 0; i < mem.num_buckets; i++) {
+            fprintf(mem.out, ",%s_kb", mem.buckets[i].name);
+        }
+        fprintf(mem.out, "\n");
+    }
+
+    fprintf(mem.out, "%lld,%llu,%lld,%llu", (long long)sim_time,
+            (unsigned long long)(mem.rss_last >> 10), (long long)mem.objects_last,
+            (unsigned long long)(mem.traced_last >> 10));
+    for (int i = 0; i < mem.num_buckets; i++) {
+        fprintf(mem.out, ",%llu", (unsigned long long)(mem.buckets[i].bytes >> 10));
+    }
+    fprintf(mem.out, "\n");
+    fflush(mem.out);
+}
+
+/**
+ * mem_growth_kb()
+ *
+ * Description:
+ *   Signed difference in KB, for report lines.
+ */
+static long long mem_growth_kb(uint64_t now, uint64_t start) {
+    return ((long long)now - (long long)start) / 1024;
+}
+
+/**
+ * mem_check_growth()
+ *
+ * Description:
+ *   Warns once each time RSS growth over the baseline crosses another
+ *   DPI_MEM_WARN_MB step, naming the domains that grew.
+ */
+static void mem_check_growth(dpi_time_t sim_time) {
+    char domains[512];
+    size_t len = 0;
+
+    if (mem.warn_bytes == 0 || mem.rss_last < mem.rss_start ||
+        mem.rss_last - mem.rss_start < mem.next_warn) {
+        return;
+    }
+
+    domains[0] = '\0';
+    for (int i = 0; i < mem.num_buckets && mem.tracemalloc != NULL && len < sizeof(domains); i++) {
+        len += snprintf(domains + len, sizeof(domains) - len, " %s %+lld KB;", mem.buckets[i].name,
+                        mem_growth_kb(mem.buckets[i].bytes, mem.buckets[i].start_bytes));
+    }
+
+    DPI_LOG_WARN("Memory grew %llu MB since sim time %lld (RSS %llu MB at %lld, %+lld objects)%s%s",
+                 (unsigned long long)((mem.rss_last - mem.rss_start) >> 20), (long long)mem.first_time,
+                 (unsigned long long)(mem.rss_last >> 20), (long long)sim_time,
+                 (long long)(mem.objects_last - mem.objects_start),
+                 domains[0] ? " Python heap:" : "", domains);
+
+    while (mem.rss_last - mem.rss_start >= mem.next_warn) {
+        mem.next_warn += mem.warn_bytes;
+    }
+}
+
+/**
+ * dpi_mem_init()
+ *
+ * Description:
+ *   Enables accounting if DPI_MEM_INTERVAL is set: reads the options and
+ *   starts tracemalloc. The first sample (the baseline) is taken at the
+ *   first DPI call after init. Must be called with the GIL held, after
+ *   Python is initialized.
+ */
+void dpi_mem_init(void) {
+    const char *interval = getenv("DPI_MEM_INTERVAL");
+    const char *warn_mb = getenv("DPI_MEM_WARN_MB");
+    const char *frames = getenv("DPI_MEM_FRAMES");
+    const char *top = getenv("DPI_MEM_TOP");
+    const char *out = getenv("DPI_MEM_OUT");
+
+    if (dpi_mem_enabled || interval == NULL || strtoll(interval, NULL, 0) <= 0) {
+        return;
+    }
+
+    mem.interval = strtoll(interval, NULL, 0);
+    mem.warn_bytes = (uint64_t)(warn_mb ? strtoll(warn_mb, NULL, 0) : MEM_DEFAULT_WARN_MB) << 20;
+    mem.frames = frames ? atoi(frames) : MEM_DEFAULT_FRAMES;
+    mem.top = top ? atoi(top) : MEM_DEFAULT_TOP;
+    mem.samples = 0;
+
+    mem.gc = PyImport_ImportModule("gc");
+    if (mem.gc == NULL) {
+        PyErr_Print();
+        return;
+    }
+
+    if (mem.frames > 0) {
+        mem.tracemalloc = PyImport_ImportModule("tracemalloc");
+        PyObject *result = mem.tracemalloc ? PyObject_CallMethod(mem.tracemalloc, "start", "i", mem.frames) : NULL;
+        if (result == NULL) {
+            PyErr_Print();
+            Py_CLEAR(mem.tracemalloc);
+            DPI_LOG_ERROR("Cannot start tracemalloc, sampling RSS and object counts only");
+        }
+        Py_XDECREF(result);
+    }
+
+    if (out != NULL && out[0] != '\0') {
+        mem.out = fopen(out, "w");
+        if (mem.out == NULL) {
+            DPI_LOG_ERROR("Cannot open DPI_MEM_OUT file %s", out);
+        }
+    }
+
+    dpi_mem_enabled = 1;
+    dpi_mem_next_sample = 0;
+    DPI_LOG_INFO("Memory accounting every %lld sim time units (tracemalloc %s, warn every %llu MB)",
+                 (long long)mem.interval, mem.tracemalloc ? "on" : "off",
+                 (unsigned long long)(mem.warn_bytes >> 20));
+}
+
+/**
+ * dpi_mem_sample()
+ *
+ * Description:
+ *   Takes one sample and schedules the next one. Called from DPI entry
+ *   points through DPI_MEM_TICK(); takes the GIL itself.
+ *
+ * Args:
+ *   sim_time: Current simulation time
+ */
+void dpi_mem_sample(dpi_time_t sim_time) {
+    PyObject *snapshot = NULL;
+
+    if (!dpi_mem_enabled) {
+        return;
+    }
+
+    dpi_core_enter();
+
+    mem.rss_last = mem_rss_bytes();
+    mem.objects_last = mem_gc_objects();
+    if (mem.tracemalloc != NULL) {
+        snapshot = PyObject_CallMethod(mem.tracemalloc, "take_snapshot", NULL);
+        if (snapshot == NULL) {
+            PyErr_Print();
+        }
+        mem.traced_last = snapshot ? mem_attribute(snapshot) : 0;
+    }
+
+    mem.samples++;
+    mem.last_time = sim_time;
+    if (mem.rss_last > mem.rss_peak) {
+        mem.rss_peak = mem.rss_last;
+    }
+
+    if (mem.samples == 1) {
+        mem.first_time = sim_time;
+        mem.rss_start = mem.rss_last;
+        mem.objects_start = mem.objects_last;
+        mem.traced_start = mem.traced_last;
+        for (int i = 0; i < mem.num_buckets; i++) {
+            mem.buckets[i].start_bytes = mem.buckets[i].bytes;
+        }
+        mem.next_warn = mem.warn_bytes;
+        mem.baseline = snapshot;        // keeps the reference
+    } else {
+        Py_XDECREF(snapshot);
+        mem_check_growth(sim_time);
+    }
+
+    mem_write_csv(sim_time);
+    dpi_core_leave();
+
+    dpi_mem_next_sample = sim_time + mem.interval;
+}
+
+/**
+ * mem_report_sites()
+ *
+ * Description:
+ *   Prints the allocation sites (file:line) that grew the most since the
+ *   baseline snapshot.
+ */
+static void mem_report_sites(void) {
+    PyObject *snapshot = NULL, *baseline = NULL, *diffs = NULL;
+    PyObject *raw = PyObject_CallMethod(mem.tracemalloc, "take_snapshot", NULL);
+
+    if (raw != NULL && mem.baseline != NULL) {
+        snapshot = mem_filter_snapshot(raw);
+        baseline = mem_filter_snapshot(mem.baseline);
+        diffs = PyObject_CallMethod(snapshot, "compare_to", "Os", baseline, "lineno");
+    }
+    Py_XDECREF(raw);
+    Py_XDECREF(baseline);
+    if (diffs == NULL) {
+        PyErr_Clear();
+        Py_XDECREF(snapshot);
+        return;
+    }
+
+    DPI_LOG_INFO("  Top allocation sites by growth:");
+    Py_ssize_t n = PyList_GET_SIZE(diffs);
+    for (Py_ssize_t i = 0; i < n && i < mem.top; i++) {
+        PyObject *diff = PyList_GET_ITEM(diffs, i);
+        PyObject *size = PyObject_GetAttrString(diff, "size");
+        PyObject *size_diff = PyObject_GetAttrString(diff, "size_diff");
+        PyObject *count_diff = PyObject_GetAttrString(diff, "count_diff");
+        PyObject *traceback = PyObject_GetAttrString(diff, "traceback");
+        PyObject *frame = traceback ? PySequence_GetItem(traceback, 0) : NULL;
+        PyObject *filename = frame ? PyObject_GetAttrString(frame, "filename") : NULL;
+        PyObject *lineno = frame ? PyObject_GetAttrString(frame, "lineno") : NULL;
+
+        if (size && size_diff && count_diff && filename && lineno) {
+            const char *file = PyUnicode_AsUTF8(filename);
+            DPI_LOG_INFO("    %+10.1f KB %+8ld blocks  %10.1f KB now  %s:%ld",
+                         PyLong_AsLongLong(size_diff) / 1024.0, PyLong_AsLong(count_diff),
+                         PyLong_AsLongLong(size) / 1024.0, file ? file : "?", PyLong_AsLong(lineno));
+        }
+        PyErr_Clear();
+
+        Py_XDECREF(lineno);
+        Py_XDECREF(filename);
+        Py_XDECREF(frame);
+        Py_XDECREF(traceback);
+        Py_XDECREF(count_diff);
+        Py_XDECREF(size_diff);
+        Py_XDECREF(size);
+    }
+
+    Py_DECREF(diffs);
+    Py_DECREF(snapshot);
+}
+
+/**
+ * mem_report_types()
+ *
+ * Description:
+ *   Prints the most common live object types (gc-tracked objects).
+ */
+static void mem_report_types(void) {
+    PyObject *objects = PyObject_CallMethod(mem.gc, "get_objects", NULL);
+    PyObject *counts = PyDict_New();
+    PyObject *ranked = NULL;
+
+    if (objects == NULL || counts == NULL) {
+        goto done;
+    }
+
+    // type -> count
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(objects); i++) {
+        PyObject *type = (PyObject*)Py_TYPE(PyList_GET_ITEM(objects, i));
+        PyObject *count = PyDict_GetItem(counts, type);
+        PyObject *next = PyLong_FromLong(count ? PyLong_AsLong(count) + 1 : 1);
+        PyDict_SetItem(counts, type, next);
+        Py_DECREF(next);
+    }
+
+    // [(count, name)], most common first
+    ranked = PyList_New(0);
+    PyObject *type, *count;
+    Py_ssize_t pos = 0;
+    while (ranked != NULL && PyDict_Next(counts, &pos, &type, &count)) {
+        PyObject *item = Py_BuildValue("(Os)", count, ((PyTypeObject*)type)->tp_name);
+        PyList_Append(ranked, item);
+        Py_XDECREF(item);
+    }
+    if (ranked == NULL || PyList_Sort(ranked) != 0 || PyList_Reverse(ranked) != 0) {
+        goto done;
+    }
+
+    DPI_LOG_INFO("  Top object types:");
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(ranked) && i < mem.top; i++) {
+        PyObject *item = PyList_GET_ITEM(ranked, i);
+        DPI_LOG_INFO("    %10ld  %s", PyLong_AsLong(PyTuple_GET_ITEM(item, 0)),
+                     PyUnicode_AsUTF8(PyTuple_GET_ITEM(item, 1)));
+    }
+
+done:
+    PyErr_Clear();
+    Py_XDECREF(ranked);
+    Py_XDECREF(counts);
+    Py_XDECREF(objects);
+}
+
+/**
+ * dpi_mem_finalize()
+ *
+ * Description:
+ *   Takes a last sample, prints the report and stops tracemalloc. Called
+ *   from dpi_finalize_python() while the plugins' Python objects are still
+ *   alive, with the GIL held.
+ */
+void dpi_mem_finalize(void) {
+    if (!dpi_mem_enabled) {
+        return;
+    }
+
+    dpi_mem_sample(mem.samples > 0 ? mem.last_time : 0);
+
+    DPI_LOG_INFO("Memory report: %llu samples, sim time %lld..%lld",
+                 (unsigned long long)mem.samples, (long long)mem.first_time, (long long)mem.last_time);
+    DPI_LOG_INFO("  RSS: start %.1f MB, peak %.1f MB, end %.1f MB",
+                 mem.rss_start / 1048576.0, mem.rss_peak / 1048576.0, mem.rss_last / 1048576.0);
+    DPI_LOG_INFO("  Live objects (gc): start %lld, end %lld",
+                 (long long)mem.objects_start, (long long)mem.objects_last);
+
+    if (mem.tracemalloc != NULL) {
+        DPI_LOG_INFO("  Python heap: start %llu KB, end %llu KB",
+                     (unsigned long long)(mem.traced_start >> 10), (unsigned long long)(mem.traced_last >> 10));
+        for (int i = 0; i < mem.num_buckets; i++) {
+            mem_bucket_t *b = &mem.buckets[i];
+            DPI_LOG_INFO("    %-10s %8llu KB -> %8llu KB (%+lld KB)", b->name,
+                         (unsigned long long)(b->start_bytes >> 10), (unsigned long long)(b->bytes >> 10),
+                         mem_growth_kb(b->bytes, b->start_bytes));
+        }
+        mem_report_sites();
+    }
+    mem_report_types();
+    fflush(stdout);
+
+    if (mem.tracemalloc != NULL) {
+        PyObject *result = PyObject_CallMethod(mem.tracemalloc, "stop", NULL);
+        Py_XDECREF(result);
+        PyErr_Clear();
+    }
+    Py_CLEAR(mem.baseline);
+    Py_CLEAR(mem.tracemalloc);
+    Py_CLEAR(mem.gc);
+
+    if (mem.out != NULL) {
+        fclose(mem.out);
+        mem.out = NULL;
+    }
+    for (int i = 0; i < mem.num_buckets; i++) {
+        mem.buckets[i].bytes = 0;
+        mem.buckets[i].start_bytes = 0;
+    }
+    mem.rss_peak = 0;
+    dpi_mem_enabled = 0;
+}
@@ -0,0 +1,25 @@
+#ifndef DPI_MEM_H
+#define DPI_MEM_H
+
+#include "dpi_types.h"
+
+// Non-zero when DPI_MEM_INTERVAL is set; checked inline so disabled accounting is one branch
+extern int dpi_mem_enabled;
+
+// Sim time at or after which the next sample is due
+extern dpi_time_t dpi_mem_next_sample;
+
+// Accounting lifecycle (local interpreter, GIL held)
+void dpi_mem_init(void);
+void dpi_mem_finalize(void);
+
+// Attribute Python allocations made in files under `path` to domain `name`
+void dpi_mem_add_domain(const char *name, const char *path);
+
+// Take one sample (use the macro below from DPI entry points)
+void dpi_mem_sample(dpi_time_t sim_time);
+
+#define DPI_MEM_TICK(sim_time) \
+    do { if (dpi_mem_enabled && (sim_time) >= dpi_mem_next_sample) dpi_mem_sample(sim_time); } while (0)
+
+#endif // DPI_MEM_H
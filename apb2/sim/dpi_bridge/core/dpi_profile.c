@@ -0,0 +1,363 @@
+/*
+ * DPI Profile - The "Logic Analyzer" for Python
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * External profilers (perf, py-spy) see the simulator binary, not the Python
+ * interpreter hidden inside it. This file samples the embedded interpreter from
+ * the inside, so you can see which Python test/parser function eats wall time.
+ *
+ * How it works:
+ * 1. SV calls `dpi_profile_start($time)`:
+ *    - A helper thread wakes up every DPI_PROFILE_INTERVAL_US microseconds
+ *      (default 5000) and records the Python call stack of the simulator thread
+ *      and of any other thread running Python at that moment (e.g. the
+ *      DPI_APB_PREFETCH producer), the latter under a `[helper thread]` frame.
+ *    - Think of it as a logic analyzer sampling a bus at a fixed rate.
+ *
+ * 2. SV calls `dpi_profile_stop($time)`:
+ *    - The samples are written to DPI_PROFILE_OUT (default `dpi_profile.folded`)
+ *      in "collapsed stack" format, one line per unique stack:
+ *          sim_1000-52000;apb_driver.py:get_transaction;apb_base.py:get_next 42
+ *    - The first frame is the sim-time window, so several windows (reset,
+ *      burst, ...) show up side by side in one flame graph.
+ *
+ * 3. Feed the file to `flamegraph.pl` or speedscope.
+ *
+ * Limits and overhead:
+ *   The sampler needs the GIL to read the stack, and the simulator thread only
+ *   lets go of it at the interpreter's thread switch points, i.e. every
+ *   `sys.getswitchinterval()` (5 ms by default) WHILE PYTHON RUNS. So:
+ *     - intervals below the switch interval give no more samples than it;
+ *     - samples show where Python time goes, not Python's share of wall time
+ *       (time spent in SV is never sampled; use DPI_TRACE for that).
+ *   Each sample costs one forced GIL handoff plus a short stack walk; nothing
+ *   is traced per Python call.
+ */
+
+#include "dpi_profile.h"
+#include "dpi_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <frameobject.h>
+
+#define PROFILE_BUCKETS 1024
+#define PROFILE_MAX_DEPTH 128
+#define PROFILE_STACK_LEN 4096
+#define PROFILE_DEFAULT_INTERVAL_US 5000
+#define PROFILE_DEFAULT_OUT "dpi_profile.folded"
+
+// One unique collapsed stack and how often it was seen
+typedef struct profile_entry {
+    char *stack;
+    uint64_t count;
+    struct profile_entry *next;
+} profile_entry_t;
+
+typedef struct {
+    pthread_t thread;
+    atomic_int running;
+    PyThreadState *target;          // Thread state of the simulator thread
+    unsigned int interval_us;
+    dpi_time_t window_start;
+    uint64_t samples;
+    profile_entry_t *buckets[PROFILE_BUCKETS];
+} profile_state_t;
+
+static profile_state_t profile = {0};
+
+/**
+ * profile_hash()
+ *
+ * Description:
+ *   djb2 string hash used to bucket collapsed stacks.
+ */
+static unsigned int profile_hash(const char *s) {
+    unsigned int h = 5381;
+    while (*s) {
+        h = ((h << 5) + h) + (unsigned char)*s++;
+    }
+    return h % PROFILE_BUCKETS;
+}
+
+/**
+ * profile_record()
+ *
+ * Description:
+ *   Adds one sample for the given collapsed stack.
+ */
+static void profile_record(const char *stack) {
+    unsigned int h = profile_hash(stack);
+
+    for (profile_entry_t *e = profile.buckets[h]; e != NULL; e = e->next) {
+        if (strcmp(e->stack, stack) == 0) {
+            e->count++;
+            return;
+        }
+    }
+
+    profile_entry_t *e = (profile_entry_t*)malloc(sizeof(profile_entry_t));
+    if (e == NULL) {
+        return;
+    }
+    e->stack = strdup(stack);
+    e->count = 1;
+    e->next = profile.buckets[h];
+    profile.buckets[h] = e;
+}
+
+/**
+ * frame_label()
+ *
+ * Description:
+ *   Formats one frame as "file.py:function" (file without directory).
+ */
+static void frame_label(PyFrameObject *frame, char *out, size_t size) {
+    PyCodeObject *code = PyFrame_GetCode(frame);
+    const char *file = PyUnicode_AsUTF8(code->co_filename);
+    const char *name = PyUnicode_AsUTF8(code->co_name);
+
+    if (file != NULL) {
+        const char *slash = strrchr(file, '/');
+        file = slash ? slash + 1 : file;
+    }
+
+    snprintf(out, size, "%s:%s", file ? file : "?", name ? name : "?");
+    Py_DECREF(code);
+}
+
+/**
+ * profile_sample_thread()
+ *
+ * Description:
+ *   Walks one thread's Python stack and records it root-first; stacks of
+ *   threads other than the simulator thread get a "[helper thread]" root.
+ *   Must be called with the GIL held.
+ */
+static void profile_sample_thread(PyThreadState *tstate) {
+    char labels[PROFILE_MAX_DEPTH][128];
+    char stack[PROFILE_STACK_LEN];
+    int depth = 0;
+
+    PyFrameObject *frame = PyThreadState_GetFrame(tstate);
+    if (frame == NULL) {
+        // Thread is not running Python right now
+        return;
+    }
+
+    while (frame != NULL && depth < PROFILE_MAX_DEPTH) {
+        frame_label(frame, labels[depth], sizeof(labels[depth]));
+        depth++;
+        PyFrameObject *back = PyFrame_GetBack(frame);
+        Py_DECREF(frame);
+        frame = back;
+    }
+    Py_XDECREF(frame);
+
+    // Collapsed stacks are written root first: a;b;c
+    size_t len = 0;
+    stack[0] = '\0';
+    if (tstate != profile.target) {
+        len = (size_t)snprintf(stack, sizeof(stack), "[helper thread];");
+    }
+    for (int i = depth - 1; i >= 0 && len < sizeof(stack); i--) {
+        len += snprintf(stack + len, sizeof(stack) - len, "%s%s",
+                        (i == depth - 1) ? "" : ";", labels[i]);
+    }
+
+    profile_record(stack);
+    profile.samples++;
+}
+
+/**
+ * profile_sample()
+ *
+ * Description:
+ *   Samples every thread of the simulator's interpreter. The sampler's own
+ *   thread state has no Python frame and is skipped. GIL held.
+ */
+static void profile_sample(void) {
+    PyInterpreterState *interp = PyThreadState_GetInterpreter(profile.target);
+
+    for (PyThreadState *t = PyInterpreterState_ThreadHead(interp); t != NULL; t = PyThreadState_Next(t)) {
+        profile_sample_thread(t);
+    }
+}
+
+/**
+ * profile_thread()
+ *
+ * Description:
+ *   Sampler thread body. Sleeps, grabs the GIL, samples, repeats.
+ */
+static void* profile_thread(void *arg) {
+    (void)arg;
+
+    while (profile.running) {
+        usleep(profile.interval_us);
+        if (!profile.running) {
+            break;
+        }
+
+        PyGILState_STATE gstate = PyGILState_Ensure();
+        if (profile.running) {
+            profile_sample();
+        }
+        PyGILState_Release(gstate);
+    }
+
+    return NULL;
+}
+
+/**
+ * profile_write()
+ *
+ * Description:
+ *   Appends the current window to the output file and clears the table.
+ */
+static void profile_write(dpi_time_t window_end) {
+    const char *path = getenv("DPI_PROFILE_OUT");
+    if (path == NULL || path[0] == '\0') {
+        path = PROFILE_DEFAULT_OUT;
+    }
+
+    char window[64];
+    if (window_end < 0) {
+        snprintf(window, sizeof(window), "sim_%lld-end", (long long)profile.window_start);
+    } else {
+        snprintf(window, sizeof(window), "sim_%lld-%lld",
+                 (long long)profile.window_start, (long long)window_end);
+    }
+
+    FILE *fp = fopen(path, "a");
+    if (fp == NULL) {
+        DPI_LOG_ERROR("Cannot open profile output: %s", path);
+    }
+
+    for (int i = 0; i < PROFILE_BUCKETS; i++) {
+        profile_entry_t *e = profile.buckets[i];
+        while (e != NULL) {
+            profile_entry_t *next = e->next;
+            if (fp != NULL) {
+                fprintf(fp, "%s;%s %llu\n", window, e->stack, (unsigned long long)e->count);
+            }
+            free(e->stack);
+            free(e);
+            e = next;
+        }
+        profile.buckets[i] = NULL;
+    }
+
+    if (fp != NULL) {
+        fclose(fp);
+        DPI_LOG_INFO("Profile window %s: %llu samples written to %s",
+                     window, (unsigned long long)profile.samples, path);
+    }
+}
+
+/**
+ * dpi_profile_start()
+ *
+ * Description:
+ *   DPI-C exported function. Starts sampling the calling (simulator) thread.
+ *   Must be called after dpi_init_python().
+ *
+ * Args:
+ *   time: Current simulation time (start of the window)
+ *
+ * Returns:
+ *   0 on success, 1 on failure.
+ */
+int dpi_profile_start(dpi_time_t time) {
+    if (!Py_IsInitialized()) {
+        DPI_LOG_ERROR("Cannot start profiler: Python not initialized");
+        return 1;
+    }
+
+    if (profile.running) {
+        DPI_LOG_INFO("Profiler already running");
+        return 0;
+    }
+
+    const char *interval = getenv("DPI_PROFILE_INTERVAL_US");
+    profile.interval_us = interval ? (unsigned int)atoi(interval) : PROFILE_DEFAULT_INTERVAL_US;
+    if (profile.interval_us == 0) {
+        profile.interval_us = PROFILE_DEFAULT_INTERVAL_US;
+    }
+
+    dpi_core_enter();
+    profile.target = PyThreadState_Get();
+    double switch_s = 0.0;
+    PyObject *sys = PyImport_ImportModule("sys");
+    PyObject *value = sys ? PyObject_CallMethod(sys, "getswitchinterval", NULL) : NULL;
+    if (value != NULL) {
+        switch_s = PyFloat_AsDouble(value);
+    }
+    PyErr_Clear();
+    Py_XDECREF(value);
+    Py_XDECREF(sys);
+    dpi_core_leave();
+
+    if (profile.interval_us < switch_s * 1e6) {
+        DPI_LOG_INFO("Profile interval %u us is below the interpreter switch interval (%.0f us): "
+                     "samples come at most once per switch interval", profile.interval_us, switch_s * 1e6);
+    }
+
+    profile.window_start = time;
+    profile.samples = 0;
+    profile.running = 1;
+
+    if (pthread_create(&profile.thread, NULL, profile_thread, NULL) != 0) {
+        profile.running = 0;
+        DPI_LOG_ERROR("Failed to create profiler thread");
+        return 1;
+    }
+
+    DPI_LOG_INFO("Profiler started at sim time %lld (interval %u us)",
+                 (long long)time, profile.interval_us);
+    return 0;
+}
+
+/**
+ * dpi_profile_stop()
+ *
+ * Description:
+ *   DPI-C exported function. Stops sampling and writes the window.
+ *
+ * Args:
+ *   time: Current simulation time (end of the window), or -1 if unknown
+ */
+void dpi_profile_stop(dpi_time_t time) {
+    if (!profile.running) {
+        return;
+    }
+
+    profile.running = 0;
+
+    // The sampler may be waiting for the GIL: let it go while we join
+    dpi_core_enter();
+    if (PyGILState_Check()) {
+        Py_BEGIN_ALLOW_THREADS
+        pthread_join(profile.thread, NULL);
+        Py_END_ALLOW_THREADS
+    } else {
+        pthread_join(profile.thread, NULL);
+    }
+    dpi_core_leave();
+
+    profile_write(time);
+}
+
+/**
+ * dpi_profile_shutdown()
+ *
+ * Description:
+ *   Closes a window left open by SV. Called before Python is finalized.
+ */
+void dpi_profile_shutdown(void) {
+    dpi_profile_stop(-1);
+}
@@ -0,0 +1,15 @@
+#ifndef DPI_PROFILE_H
+#define DPI_PROFILE_H
+
+#include "dpi_types.h"
+
+// DPI-C exported functions for SystemVerilog
+// Start/stop sampling the embedded interpreter; each start/stop pair is one
+// sim-time window in the collapsed stack output
+int dpi_profile_start(dpi_time_t time);
+void dpi_profile_stop(dpi_time_t time);
+
+// Stop any running window (called from dpi_finalize_python)
+void dpi_profile_shutdown(void);
+
+#endif // DPI_PROFILE_H
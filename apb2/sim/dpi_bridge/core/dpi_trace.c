@@ -0,0 +1,326 @@
+/*
+ * DPI Trace - The "Waveform Dump" for the Bridge
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * Counters tell you HOW MUCH time Python took; this file tells you WHEN.
+ * It is the software equivalent of a VCD dump: every crossing between SV, C
+ * and Python is recorded as a begin/end pair with both wall-clock and sim time.
+ *
+ * How to use:
+ *   DPI_TRACE=bridge_trace.json sim.py ...
+ *   Open the file in https://ui.perfetto.dev or chrome://tracing.
+ *
+ * What gets recorded:
+ *   - dpi:    DPI-C entry points (dpi_get_transaction, dpi_send_object, ...)
+ *   - plugin: Plugin init/cleanup
+ *   - python: Every Python function call made through dpi_core_call_function()
+ *   - A "sim_time" counter track, so you can see where sim time stands still
+ *     while wall time runs (Python stalls) and vice versa.
+ *
+ * Cost:
+ *   Events are appended to a per-thread arena (no locks, no I/O). The JSON file
+ *   is only written at dpi_finalize_python(). When DPI_TRACE is not set every
+ *   trace point is a single branch.
+ *
+ * Memory:
+ *   Each event takes ~72 bytes and a transaction records several, so a long
+ *   regression could fill the host before anything is written. Recording stops
+ *   after DPI_TRACE_MAX_EVENTS spans (begin/end pairs, default 1000000,
+ *   ~150 MB; 0 = no limit): the file keeps the start of the run, and the
+ *   number of dropped events is logged and stored in the JSON "metadata".
+ *   Spans already open when the limit is hit still get their end event.
+ */
+
+#include "dpi_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define TRACE_CHUNK_EVENTS 4096
+#define TRACE_NAME_LEN 48
+#define TRACE_DEFAULT_MAX_EVENTS 1000000     // Spans, i.e. begin events
+
+// One begin or end event
+typedef struct {
+    char name[TRACE_NAME_LEN];
+    char phase;                     // 'B' or 'E'
+    unsigned char cat;
+    uint64_t wall_ns;               // Nanoseconds since dpi_trace_init()
+    dpi_time_t sim_time;
+} trace_event_t;
+
+// Fixed-size block of events; arenas grow by chaining chunks
+typedef struct trace_chunk {
+    trace_event_t events[TRACE_CHUNK_EVENTS];
+    int count;
+    struct trace_chunk *next;
+} trace_chunk_t;
+
+// Per-thread event arena
+typedef struct trace_arena {
+    long tid;
+    dpi_time_t last_sim_time;       // Last explicit sim time seen by this thread
+    int skip_depth;                 // Begin events dropped and not yet ended
+    trace_chunk_t *head;
+    trace_chunk_t *tail;
+    struct trace_arena *next;
+} trace_arena_t;
+
+static const char *trace_cat_names[] = {"dpi", "plugin", "python"};
+
+int dpi_trace_enabled = 0;
+
+static char *trace_path = NULL;
+static uint64_t trace_t0_ns = 0;
+static trace_arena_t *trace_arenas = NULL;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int trace_generation = 0;     // Bumped on finalize to drop stale TLS arenas
+static uint64_t trace_max_events = 0;         // 0 = unlimited
+static atomic_ullong trace_recorded;          // Begin events stored, all threads
+static atomic_ullong trace_dropped;           // Events dropped over the limit
+static __thread trace_arena_t *tls_arena = NULL;
+static __thread unsigned int tls_generation = 0;
+
+static uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * trace_get_arena()
+ *
+ * Description:
+ *   Returns the calling thread's arena, creating it on first use.
+ *   Only arena creation takes the lock; recording itself is lock-free.
+ */
+static trace_arena_t* trace_get_arena(void) {
+    if (tls_arena != NULL && tls_generation == trace_generation) {
+        return tls_arena;
+    }
+
+    trace_arena_t *arena = (trace_arena_t*)calloc(1, sizeof(trace_arena_t));
+    if (arena == NULL) {
+        return NULL;
+    }
+    arena->tid = (long)syscall(SYS_gettid);
+
+    pthread_mutex_lock(&trace_lock);
+    arena->next = trace_arenas;
+    trace_arenas = arena;
+    pthread_mutex_unlock(&trace_lock);
+
+    tls_arena = arena;
+    tls_generation = trace_generation;
+    return arena;
+}
+
+/**
+ * trace_record()
+ *
+ * Description:
+ *   Appends one event to the calling thread's arena.
+ */
+static void trace_record(char phase, dpi_trace_cat_t cat, const char *name, dpi_time_t sim_time) {
+    trace_arena_t *arena = trace_get_arena();
+    if (arena == NULL) {
+        return;
+    }
+
+    // Over the limit: drop begin events and their ends, but still close the
+    // spans recorded before the limit so the file stays balanced
+    if (trace_max_events > 0) {
+        int drop;
+        if (phase == 'E') {
+            drop = arena->skip_depth > 0;
+            if (drop) {
+                arena->skip_depth--;
+            }
+        } else {
+            drop = atomic_fetch_add_explicit(&trace_recorded, 1, memory_order_relaxed) >= trace_max_events;
+            if (drop) {
+                arena->skip_depth++;
+            }
+        }
+        if (drop) {
+            if (atomic_fetch_add_explicit(&trace_dropped, 1, memory_order_relaxed) == 0) {
+                DPI_LOG_WARN("Bridge timeline reached DPI_TRACE_MAX_EVENTS=%llu, later events are dropped",
+                             (unsigned long long)trace_max_events);
+            }
+            return;
+        }
+    }
+
+    if (arena->tail == NULL || arena->tail->count == TRACE_CHUNK_EVENTS) {
+        trace_chunk_t *chunk = (trace_chunk_t*)malloc(sizeof(trace_chunk_t));
+        if (chunk == NULL) {
+            return;
+        }
+        chunk->count = 0;
+        chunk->next = NULL;
+        if (arena->tail != NULL) {
+            arena->tail->next = chunk;
+        } else {
+            arena->head = chunk;
+        }
+        arena->tail = chunk;
+    }
+
+    // Per thread: a helper thread (prefetch) works at its own sim time
+    if (sim_time == DPI_TRACE_TIME_LAST) {
+        sim_time = arena->last_sim_time;
+    } else {
+        arena->last_sim_time = sim_time;
+    }
+
+    trace_event_t *ev = &arena->tail->events[arena->tail->count++];
+    snprintf(ev->name, sizeof(ev->name), "%s", name ? name : "?");
+    ev->phase = phase;
+    ev->cat = (unsigned char)cat;
+    ev->wall_ns = trace_now_ns() - trace_t0_ns;
+    ev->sim_time = sim_time;
+}
+
+/**
+ * dpi_trace_init()
+ *
+ * Description:
+ *   Enables the recorder if the DPI_TRACE environment variable names an
+ *   output file. Safe to call more than once.
+ */
+void dpi_trace_init(void) {
+    if (dpi_trace_enabled) {
+        return;
+    }
+
+    const char *path = getenv("DPI_TRACE");
+    if (path == NULL || path[0] == '\0') {
+        return;
+    }
+
+    const char *max_events = getenv("DPI_TRACE_MAX_EVENTS");
+    trace_max_events = max_events ? strtoull(max_events, NULL, 0) : TRACE_DEFAULT_MAX_EVENTS;
+    atomic_store(&trace_recorded, 0);
+    atomic_store(&trace_dropped, 0);
+
+    trace_path = strdup(path);
+    trace_t0_ns = trace_now_ns();
+    dpi_trace_enabled = 1;
+    DPI_LOG_INFO("Bridge timeline recording to %s (max %llu spans)", trace_path,
+                 (unsigned long long)trace_max_events);
+}
+
+void dpi_trace_begin(dpi_trace_cat_t cat, const char *name, dpi_time_t sim_time) {
+    trace_record('B', cat, name, sim_time);
+}
+
+void dpi_trace_end(dpi_trace_cat_t cat, const char *name, dpi_time_t sim_time) {
+    trace_record('E', cat, name, sim_time);
+}
+
+/**
+ * trace_write_string()
+ *
+ * Description:
+ *   Writes a JSON string literal, escaping quotes, backslashes and controls.
+ */
+static void trace_write_string(FILE *fp, const char *s) {
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', fp);
+            fputc(*s, fp);
+        } else if ((unsigned char)*s < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char)*s);
+        } else {
+            fputc(*s, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+/**
+ * dpi_trace_finalize()
+ *
+ * Description:
+ *   Writes all arenas as Chrome trace JSON and frees them.
+ *   Called at the very end of dpi_finalize_python().
+ */
+void dpi_trace_finalize(void) {
+    if (!dpi_trace_enabled) {
+        return;
+    }
+    dpi_trace_enabled = 0;
+
+    FILE *fp = fopen(trace_path, "w");
+    if (fp == NULL) {
+        DPI_LOG_ERROR("Cannot open trace output: %s", trace_path);
+    }
+
+    uint64_t total = 0;
+    int first = 1;
+    long pid = (long)getpid();
+
+    if (fp != NULL) {
+        fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    }
+
+    pthread_mutex_lock(&trace_lock);
+    trace_arena_t *arena = trace_arenas;
+    while (arena != NULL) {
+        trace_chunk_t *chunk = arena->head;
+        while (chunk != NULL) {
+            for (int i = 0; fp != NULL && i < chunk->count; i++) {
+                trace_event_t *ev = &chunk->events[i];
+                double ts_us = (double)ev->wall_ns / 1000.0;
+
+                fprintf(fp, "%s{\"name\":", first ? "" : ",\n");
+                trace_write_string(fp, ev->name);
+                fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%ld,\"tid\":%ld,"
+                            "\"args\":{\"sim_time\":%lld}}",
+                        trace_cat_names[ev->cat], ev->phase, ts_us, pid, arena->tid,
+                        (long long)ev->sim_time);
+
+                // Sim time counter track: one sample per begin event
+                if (ev->phase == 'B') {
+                    fprintf(fp, ",\n{\"name\":\"sim_time\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%ld,"
+                                "\"args\":{\"sim_time\":%lld}}",
+                            ts_us, pid, (long long)ev->sim_time);
+                }
+                first = 0;
+                total++;
+            }
+            trace_chunk_t *next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+        trace_arena_t *next = arena->next;
+        free(arena);
+        arena = next;
+    }
+    trace_arenas = NULL;
+    trace_generation++;
+    pthread_mutex_unlock(&trace_lock);
+
+    uint64_t dropped = atomic_load(&trace_dropped);
+    if (fp != NULL) {
+        fprintf(fp, "\n],\n\"metadata\":{\"dpi_trace_max_events\":%llu,\"dpi_trace_dropped_events\":%llu}}\n",
+                (unsigned long long)trace_max_events, (unsigned long long)dropped);
+        fclose(fp);
+        DPI_LOG_INFO("Bridge timeline: %llu events written to %s",
+                     (unsigned long long)total, trace_path);
+    }
+    if (dropped > 0) {
+        DPI_LOG_WARN("Bridge timeline: %llu events dropped over DPI_TRACE_MAX_EVENTS=%llu",
+                     (unsigned long long)dropped, (unsigned long long)trace_max_events);
+    }
+
+    free(trace_path);
+    trace_path = NULL;
+}
@@ -0,0 +1,33 @@
+#ifndef DPI_TRACE_H
+#define DPI_TRACE_H
+
+#include "dpi_types.h"
+
+// Sim time value meaning "use the last sim time seen by the recorder"
+#define DPI_TRACE_TIME_LAST ((dpi_time_t)-1)
+
+// Event categories (shown as "cat" in the trace viewer)
+typedef enum {
+    DPI_TRACE_CAT_DPI = 0,      // DPI-C entry points called from SV
+    DPI_TRACE_CAT_PLUGIN,       // Plugin init/cleanup
+    DPI_TRACE_CAT_PYTHON        // Calls into Python functions
+} dpi_trace_cat_t;
+
+// Non-zero when DPI_TRACE is set; checked inline so disabled tracing is one branch
+extern int dpi_trace_enabled;
+
+// Recorder lifecycle
+void dpi_trace_init(void);
+void dpi_trace_finalize(void);
+
+// Event recording (use the macros below)
+void dpi_trace_begin(dpi_trace_cat_t cat, const char *name, dpi_time_t sim_time);
+void dpi_trace_end(dpi_trace_cat_t cat, const char *name, dpi_time_t sim_time);
+
+#define DPI_TRACE_BEGIN(cat, name, sim_time) \
+    do { if (dpi_trace_enabled) dpi_trace_begin(cat, name, sim_time); } while (0)
+
+#define DPI_TRACE_END(cat, name, sim_time) \
+    do { if (dpi_trace_enabled) dpi_trace_end(cat, name, sim_time); } while (0)
+
+#endif // DPI_TRACE_H
@@ -26,6 +26,9 @@ typedef enum {
 #define DPI_LOG_ERROR(fmt, ...) \
     fprintf(stderr, "[DPI-ERROR] " fmt "\n", ##__VA_ARGS__)
 
+#define DPI_LOG_WARN(fmt, ...) \
+    fprintf(stderr, "[DPI-WARN] " fmt "\n", ##__VA_ARGS__)
+
 #define DPI_LOG_DEBUG(fmt, ...) \
     printf("[DPI-DEBUG] " fmt "\n", ##__VA_ARGS__)
 
@@ -0,0 +1,372 @@
+/*
+ * DPI Warm Start - The "Hot Standby"
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * Booting Python, importing the drivers/parsers and initializing plugins costs
+ * far more than a sub-second directed test. In a test farm we pay that for every
+ * single simulation.
+ *
+ * Warm start moves that cost into a resident server (`dpi_warm_server.py`):
+ *   - The server boots Python ONCE and imports apb_driver, apb_base,
+ *     object_receiver, the parsers and all tests.
+ *   - Each simulation connects to it over a UNIX socket; the server `fork()`s a
+ *     worker that already has everything loaded (copy-on-write pages).
+ *   - The simulator process never starts its own interpreter. This file turns
+ *     the plugin DPI calls into small binary messages for that worker.
+ *
+ * How to use:
+ *   python3 dpi_bridge/core/dpi_warm_server.py --socket /tmp/dpi_warm.sock &
+ *   DPI_WARM_SOCKET=/tmp/dpi_warm.sock APB_TEST=apb_burst_test sim.py ...
+ *
+ * The simulator's stdout/stderr are handed to the worker when connecting, so
+ * Python prints still land in the simulation log.
+ *
+ * Wire format (host byte order, both ends run on the same machine):
+ *   request header: uint8 opcode, uint32 payload length, then the payload.
+ *   See DPI_WARM_OP_* in dpi_warm.h and the server for the payload layouts.
+ *
+ * Limitations:
+ *   C-side object filters (generic_filter.c), object capture (generic_capture.c),
+ *   the profiler and memory accounting (dpi_mem.c) work with the local plugins
+ *   only, so they are inactive here.
+ */
+
+#include "dpi_warm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+static int warm_fd = -1;
+
+/**
+ * dpi_warm_requested()
+ *
+ * Description:
+ *   Returns non-zero if DPI_WARM_SOCKET is set (warm start wanted).
+ */
+int dpi_warm_requested(void) {
+    const char *path = getenv("DPI_WARM_SOCKET");
+    return path != NULL && path[0] != '\0';
+}
+
+/**
+ * dpi_warm_active()
+ *
+ * Description:
+ *   Returns non-zero while connected to a warm worker.
+ */
+int dpi_warm_active(void) {
+    return warm_fd >= 0;
+}
+
+/**
+ * warm_write_all() / warm_read_all()
+ *
+ * Description:
+ *   Full-length socket I/O, retrying on short transfers and EINTR.
+ */
+static int warm_write_all(struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t n = writev(warm_fd, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            DPI_LOG_ERROR("Warm worker write failed: %s", strerror(errno));
+            return DPI_ERROR;
+        }
+
+        // Skip fully written buffers, then advance inside the partial one
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return DPI_SUCCESS;
+}
+
+static int warm_read_all(void *buf, size_t len) {
+    char *p = (char*)buf;
+    while (len > 0) {
+        ssize_t n = read(warm_fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            DPI_LOG_ERROR("Warm worker closed the connection");
+            return DPI_ERROR;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return DPI_SUCCESS;
+}
+
+/**
+ * warm_send()
+ *
+ * Description:
+ *   Sends one request: header + up to three payload pieces.
+ */
+static int warm_send(uint8_t op, const void *p0, size_t l0, const void *p1, size_t l1,
+                     const void *p2, size_t l2) {
+    char header[5];
+    uint32_t len = (uint32_t)(l0 + l1 + l2);
+
+    header[0] = (char)op;
+    memcpy(header + 1, &len, sizeof(len));
+
+    struct iovec iov[4] = {
+        {header, sizeof(header)},
+        {(void*)p0, l0},
+        {(void*)p1, l1},
+        {(void*)p2, l2}
+    };
+
+    if (warm_write_all(iov, 4) != DPI_SUCCESS) {
+        close(warm_fd);
+        warm_fd = -1;
+        return DPI_ERROR;
+    }
+    return DPI_SUCCESS;
+}
+
+/**
+ * warm_send_hello()
+ *
+ * Description:
+ *   First message: test name as payload, with our stdout/stderr attached as
+ *   SCM_RIGHTS so the worker prints into the simulation log.
+ */
+static int warm_send_hello(const char *test_name) {
+    char header[5];
+    uint32_t len = (uint32_t)strlen(test_name);
+    int fds[2] = {STDOUT_FILENO, STDERR_FILENO};
+    char control[CMSG_SPACE(sizeof(fds))];
+
+    header[0] = (char)DPI_WARM_OP_HELLO;
+    memcpy(header + 1, &len, sizeof(len));
+
+    struct iovec iov[2] = {
+        {header, sizeof(header)},
+        {(void*)test_name, len}
+    };
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    memset(control, 0, sizeof(control));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    fflush(stdout);
+    fflush(stderr);
+
+    // The first sendmsg carries the descriptors; finish any remainder normally
+    ssize_t n = sendmsg(warm_fd, &msg, 0);
+    if (n < 0) {
+        DPI_LOG_ERROR("Warm worker hello failed: %s", strerror(errno));
+        return DPI_ERROR;
+    }
+
+    size_t total = sizeof(header) + len;
+    if ((size_t)n < total) {
+        struct iovec rest;
+        if ((size_t)n < sizeof(header)) {
+            DPI_LOG_ERROR("Warm worker hello truncated");
+            return DPI_ERROR;
+        }
+        rest.iov_base = (char*)test_name + (n - (ssize_t)sizeof(header));
+        rest.iov_len = total - (size_t)n;
+        return warm_write_all(&rest, 1);
+    }
+
+    return DPI_SUCCESS;
+}
+
+/**
+ * dpi_warm_connect()
+ *
+ * Description:
+ *   Connects to the warm server named by DPI_WARM_SOCKET and selects the
+ *   Python test (APB_TEST) in the forked worker.
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+int dpi_warm_connect(void) {
+    const char *path = getenv("DPI_WARM_SOCKET");
+    const char *test_name = getenv("APB_TEST");
+    struct sockaddr_un addr;
+    int32_t status = -1;
+
+    if (warm_fd >= 0) {
+        DPI_LOG_INFO("Warm worker already connected");
+        return DPI_SUCCESS;
+    }
+
+    if (path == NULL || strlen(path) >= sizeof(addr.sun_path)) {
+        DPI_LOG_ERROR("Invalid DPI_WARM_SOCKET path");
+        return DPI_ERROR;
+    }
+
+    warm_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (warm_fd < 0) {
+        DPI_LOG_ERROR("Cannot create socket: %s", strerror(errno));
+        return DPI_ERROR;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (connect(warm_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        DPI_LOG_ERROR("Cannot connect to warm server %s: %s", path, strerror(errno));
+        close(warm_fd);
+        warm_fd = -1;
+        return DPI_ERROR;
+    }
+
+    if (warm_send_hello(test_name ? test_name : "") != DPI_SUCCESS ||
+        warm_read_all(&status, sizeof(status)) != DPI_SUCCESS ||
+        status != 0) {
+        DPI_LOG_ERROR("Warm worker failed to load test");
+        close(warm_fd);
+        warm_fd = -1;
+        return DPI_ERROR;
+    }
+
+    DPI_LOG_INFO("Connected to warm worker via %s", path);
+    return DPI_SUCCESS;
+}
+
+/**
+ * dpi_warm_disconnect()
+ *
+ * Description:
+ *   Tells the worker to exit and closes the socket. Waits for the worker's
+ *   acknowledgement so all of its output is in the log before SV continues.
+ */
+void dpi_warm_disconnect(void) {
+    int32_t status;
+
+    if (warm_fd < 0) {
+        return;
+    }
+
+    if (warm_send(DPI_WARM_OP_BYE, NULL, 0, NULL, 0, NULL, 0) == DPI_SUCCESS) {
+        warm_read_all(&status, sizeof(status));
+    }
+    if (warm_fd >= 0) {
+        close(warm_fd);
+        warm_fd = -1;
+    }
+    DPI_LOG_INFO("Disconnected from warm worker");
+}
+
+/**
+ * dpi_warm_load_test()
+ *
+ * Description:
+ *   Switches the worker's Python test. An empty name resets the worker to
+ *   its default test (session reset). Reply: int32 status.
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+int dpi_warm_load_test(const char *test_name) {
+    int32_t status = -1;
+
+    if (warm_send(DPI_WARM_OP_LOAD_TEST, test_name, strlen(test_name), NULL, 0, NULL, 0) != DPI_SUCCESS ||
+        warm_read_all(&status, sizeof(status)) != DPI_SUCCESS) {
+        return DPI_ERROR;
+    }
+
+    return status == 0 ? DPI_SUCCESS : DPI_ERROR;
+}
+
+/**
+ * dpi_warm_get_transaction()
+ *
+ * Description:
+ *   Remote dpi_get_transaction(). Reply: int32 valid (DPI_WARM_TXN_*),
+ *   int32 is_write, int64 addr, int64 data.
+ *
+ * Returns:
+ *   1 if transaction available, 0 if none.
+ */
+int dpi_warm_get_transaction(dpi_time_t time, int *is_write, int *addr, int *data) {
+    char raw[24];
+    int32_t valid, write;
+    int64_t a, d;
+
+    if (warm_send(DPI_WARM_OP_GET_TXN, &time, sizeof(time), NULL, 0, NULL, 0) != DPI_SUCCESS ||
+        warm_read_all(raw, sizeof(raw)) != DPI_SUCCESS) {
+        return 0;
+    }
+
+    memcpy(&valid, raw, 4);
+    memcpy(&write, raw + 4, 4);
+    memcpy(&a, raw + 8, 8);
+    memcpy(&d, raw + 16, 8);
+
+    if (valid == DPI_WARM_TXN_ERROR) {
+        DPI_LOG_ERROR("Warm worker could not encode the transaction (see worker log)");
+        return 0;
+    }
+    if (valid != DPI_WARM_TXN_VALID) {
+        return 0;
+    }
+
+    *is_write = (int)write;
+    *addr = (int)a;
+    *data = (int)d;
+    return 1;
+}
+
+/**
+ * dpi_warm_send_read_data()
+ *
+ * Description:
+ *   Remote dpi_send_read_data(). Payload: int64 time, int64 data. No reply.
+ */
+void dpi_warm_send_read_data(dpi_time_t time, int data) {
+    int64_t value = (int64_t)(uint32_t)data;
+    warm_send(DPI_WARM_OP_READ_DATA, &time, sizeof(time), &value, sizeof(value), NULL, 0);
+}
+
+/**
+ * dpi_warm_send_object()
+ *
+ * Description:
+ *   Remote dpi_send_timed_object(). Payload: int64 time, uint32 tag length,
+ *   tag bytes, object bytes. No reply.
+ */
+void dpi_warm_send_object(dpi_time_t time, const char *tag, const char *object_str) {
+    char prefix[12];
+    uint32_t tag_len = (uint32_t)strlen(tag);
+
+    memcpy(prefix, &time, 8);
+    memcpy(prefix + 8, &tag_len, 4);
+
+    warm_send(DPI_WARM_OP_SEND_OBJECT, prefix, sizeof(prefix), tag, tag_len,
+              object_str, strlen(object_str));
+}
@@ -0,0 +1,31 @@
+#ifndef DPI_WARM_H
+#define DPI_WARM_H
+
+#include "dpi_types.h"
+
+// Message opcodes shared with dpi_warm_server.py
+#define DPI_WARM_OP_HELLO       1
+#define DPI_WARM_OP_GET_TXN     2
+#define DPI_WARM_OP_READ_DATA   3
+#define DPI_WARM_OP_SEND_OBJECT 4
+#define DPI_WARM_OP_BYE         5
+#define DPI_WARM_OP_LOAD_TEST   6
+
+// GET_TXN reply valid field
+#define DPI_WARM_TXN_NONE       0
+#define DPI_WARM_TXN_VALID      1
+#define DPI_WARM_TXN_ERROR      (-1)
+
+// Warm-start session management
+int dpi_warm_requested(void);
+int dpi_warm_active(void);
+int dpi_warm_connect(void);
+void dpi_warm_disconnect(void);
+int dpi_warm_load_test(const char *test_name);
+
+// Remote versions of the plugin entry points
+int dpi_warm_get_transaction(dpi_time_t time, int *is_write, int *addr, int *data);
+void dpi_warm_send_read_data(dpi_time_t time, int data);
+void dpi_warm_send_object(dpi_time_t time, const char *tag, const char *object_str);
+
+#endif // DPI_WARM_H
@@ -0,0 +1,241 @@
+"""
+DPI Warm Start Server
+
+Boots Python once, imports the APB driver, the object receiver, the parsers and
+all test modules, then forks a ready-made worker for every simulation that
+connects. The simulator side is dpi_bridge/core/dpi_warm.c.
+
+Usage (from the sim/ directory):
+    python3 dpi_bridge/core/dpi_warm_server.py --socket /tmp/dpi_warm.sock
+    DPI_WARM_SOCKET=/tmp/dpi_warm.sock APB_TEST=apb_basic_test sim.py ...
+"""
+
+import argparse
+import glob
+import os
+import random
+import signal
+import socket
+import struct
+import sys
+import traceback
+
+# Opcodes, must match DPI_WARM_OP_* in dpi_warm.h
+OP_HELLO = 1
+OP_GET_TXN = 2
+OP_READ_DATA = 3
+OP_SEND_OBJECT = 4
+OP_BYE = 5
+OP_LOAD_TEST = 6
+
+# Native byte order and sizes, no padding (same machine as the simulator)
+HEADER = struct.Struct("=BI")
+TIME = struct.Struct("=q")
+READ_DATA = struct.Struct("=qq")
+OBJECT_PREFIX = struct.Struct("=qI")
+TXN_REPLY = struct.Struct("=iiqq")
+STATUS_REPLY = struct.Struct("=i")
+
+# TXN_REPLY valid field, must match DPI_WARM_TXN_* in dpi_warm.h
+TXN_NONE = 0
+TXN_VALID = 1
+TXN_ERROR = -1
+
+# Same search paths as dpi_core_init_python() and the plugins
+SEARCH_PATHS = ['.', './sim', './dpi_bridge/plugins', './tests',
+                './dpi_bridge/plugins/generic/parsers']
+
+
+def preload():
+    """
+    Import everything a simulation would import in dpi_init_python().
+
+    Returns:
+        Tuple of (apb_driver, object_receiver) modules
+    """
+    for path in SEARCH_PATHS:
+        if path not in sys.path:
+            sys.path.append(path)
+
+    import apb_driver
+    import object_receiver
+
+    # Test modules are small; importing them all lets any APB_TEST start warm
+    for test_file in sorted(glob.glob('./tests/*_test.py')):
+        apb_driver._import_test(os.path.splitext(os.path.basename(test_file))[0])
+
+    print(f"[WarmServer] Preloaded {len(sys.modules)} modules", flush=True)
+    return apb_driver, object_receiver
+
+
+def recv_exact(conn, size):
+    """Read exactly size bytes, or return None if the peer closed."""
+    buf = bytearray()
+    while len(buf) < size:
+        chunk = conn.recv(size - len(buf))
+        if not chunk:
+            return None
+        buf += chunk
+    return bytes(buf)
+
+
+def recv_hello(conn):
+    """
+    Receive the HELLO message together with the simulator's stdout/stderr.
+
+    Returns:
+        Test name (may be empty) or None on error
+    """
+    data, fds, _, _ = socket.recv_fds(conn, HEADER.size + 4096, 2)
+    if len(data) < HEADER.size:
+        return None
+
+    op, length = HEADER.unpack_from(data)
+    if op != OP_HELLO:
+        return None
+
+    payload = data[HEADER.size:]
+    if len(payload) < length:
+        rest = recv_exact(conn, length - len(payload))
+        if rest is None:
+            return None
+        payload += rest
+
+    # Print into the simulation log instead of the server's terminal
+    sys.stdout.flush()
+    sys.stderr.flush()
+    for target, fd in zip((1, 2), fds):
+        os.dup2(fd, target)
+        os.close(fd)
+
+    return payload[:length].decode()
+
+
+def serve(conn, apb_driver, object_receiver):
+    """
+    Worker loop: answer DPI requests from one simulation until BYE.
+    """
+    test_name = recv_hello(conn)
+    if test_name is None:
+        return
+
+    # Use the simulator's APB_TEST, not the server's, for this worker and any
+    # later reset() of the session
+    if test_name:
+        os.environ['APB_TEST'] = test_name
+    else:
+        os.environ.pop('APB_TEST', None)
+
+    # Each worker gets its own random stream, like a fresh interpreter would.
+    # The sequence built by the preload import drew its data before the fork
+    # and is shared by every worker, so always build a new one after seeding.
+    random.seed()
+    apb_driver.load_test(apb_driver.default_test_name())
+    status = 0 if apb_driver.current_sequence is not None else 1
+    conn.sendall(STATUS_REPLY.pack(status))
+
+    while True:
+        header = recv_exact(conn, HEADER.size)
+        if header is None:
+            return
+        op, length = HEADER.unpack(header)
+        payload = recv_exact(conn, length) if length else b''
+        if payload is None:
+            return
+
+        if op == OP_GET_TXN:
+            (sim_time,) = TIME.unpack(payload)
+            txn = apb_driver.get_transaction(sim_time)
+            if txn is None:
+                conn.sendall(TXN_REPLY.pack(TXN_NONE, 0, 0, 0))
+                continue
+            try:
+                # APB addr/data are 32 bits wide, as in the in-process path
+                is_write, addr, data = txn
+                reply = TXN_REPLY.pack(TXN_VALID, int(is_write),
+                                       int(addr) & 0xFFFFFFFF, int(data) & 0xFFFFFFFF)
+            except (struct.error, TypeError, ValueError) as e:
+                print(f"[WarmServer] Bad transaction {txn!r}: {e}", flush=True)
+                reply = TXN_REPLY.pack(TXN_ERROR, 0, 0, 0)
+            conn.sendall(reply)
+
+        elif op == OP_READ_DATA:
+            sim_time, data = READ_DATA.unpack(payload)
+            apb_driver.send_read_data(sim_time, data)
+
+        elif op == OP_SEND_OBJECT:
+            sim_time, tag_len = OBJECT_PREFIX.unpack_from(payload)
+            tag = payload[OBJECT_PREFIX.size:OBJECT_PREFIX.size + tag_len].decode()
+            object_str = payload[OBJECT_PREFIX.size + tag_len:].decode()
+            object_receiver.receive_object(tag, object_str)
+
+        elif op == OP_LOAD_TEST:
+            name = payload.decode()
+            if name:
+                ok = apb_driver.load_test(name)
+            else:
+                ok = apb_driver.reset()
+            conn.sendall(STATUS_REPLY.pack(0 if ok else 1))
+
+        elif op == OP_BYE:
+            # Flush before acknowledging so the log is complete when SV moves on
+            sys.stdout.flush()
+            sys.stderr.flush()
+            conn.sendall(STATUS_REPLY.pack(0))
+            return
+
+        else:
+            print(f"[WarmServer] Unknown opcode {op}", flush=True)
+            return
+
+
+def main():
+    parser = argparse.ArgumentParser(description="DPI bridge warm start server")
+    parser.add_argument('--socket', default=os.environ.get('DPI_WARM_SOCKET', '/tmp/dpi_warm.sock'),
+                        help="UNIX socket path (default: $DPI_WARM_SOCKET or /tmp/dpi_warm.sock)")
+    args = parser.parse_args()
+
+    apb_driver, object_receiver = preload()
+
+    if os.path.exists(args.socket):
+        os.unlink(args.socket)
+
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(args.socket)
+    server.listen(64)
+
+    # Workers are never waited for; let the kernel reap them
+    signal.signal(signal.SIGCHLD, signal.SIG_IGN)
+
+    print(f"[WarmServer] Listening on {args.socket}", flush=True)
+
+    try:
+        while True:
+            conn, _ = server.accept()
+            pid = os.fork()
+            if pid == 0:
+                server.close()
+                signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+                status = 0
+                try:
+                    serve(conn, apb_driver, object_receiver)
+                except Exception:
+                    # stderr is the simulator's once HELLO is through
+                    traceback.print_exc()
+                    status = 1
+                finally:
+                    sys.stdout.flush()
+                    sys.stderr.flush()
+                    conn.close()
+                    os._exit(status)
+            conn.close()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.close()
+        if os.path.exists(args.socket):
+            os.unlink(args.socket)
+
+
+if __name__ == '__main__':
+    main()
@@ -13,10 +13,31 @@
  *    - Python returns a tuple: `(is_write, addr, data)`.
  *    - C unpacks this tuple and puts values into the `int*` output arguments.
  * 
- * 2. `dpi_send_read_data(...)`:
+ * 1b. `dpi_get_request(...)` (preferred):
+ *    - Same question, but the answer is a typed record described once in
+ *      `apb_request.h` (64-bit address/data, strobe, prot, delay, ...).
+ *    - C owns ONE preallocated record buffer; Python `fill_request()` writes
+ *      the fields in place through a memoryview (no tuple per transaction).
+ *    - C packs the fields into the SV packed vector (`svBitVecVal` words).
+ * 
+ * 2. `dpi_load_test(...)`:
+ *    - Switches the Python test inside a running session.
+ *    - Python re-imports the test module if its file changed on disk.
+ * 
+ * 3. `dpi_send_read_data(...)`:
  *    - SV calls this after a read completes.
  *    - C packs the data into a Python integer and calls `send_read_data()`.
  * 
+ * 3b. `dpi_op_done(...)`:
+ *    - Requests can also be opcodes (`op` field): wait N clocks, wait for
+ *      reset, or poll a register. SV runs them without calling Python and
+ *      reports each one once when it finishes.
+ *    - C calls Python `op_done(time, status, data)`.
+ * 
+ * 4. Prefetch (optional, see `apb_prefetch.c`):
+ *    - With DPI_APB_PREFETCH=<depth>, a helper thread runs the Python sequence
+ *      ahead of the simulator and the two calls above only touch a queue.
+ * 
  * When to use this style?
  * - High Performance: Passing raw integers is faster than parsing strings.
  * - Complex C Logic: If you need to do heavy computation in C before Python sees it.
@@ -28,16 +49,162 @@
 #include "apb_plugin.h"
 #include "../plugin_interface.h"
 #include "../../core/dpi_core.h"
+#include "../../core/dpi_mem.h"
+#include "../../core/dpi_trace.h"
+#include "../../core/dpi_warm.h"
+#include "apb_request.h"
+#include "apb_prefetch.h"
 #include <stdio.h>
+#include <string.h>
 
 // APB Plugin private data
 typedef struct {
     PyObject *module;
     PyObject *func_get_transaction;
     PyObject *func_send_read_data;
+    PyObject *func_fill_request;    // Optional: record-based request path
+    PyObject *func_op_done;         // Optional: opcode completions
+    PyObject *request_buf;          // bytearray backing the request record
+    PyObject *request_view;         // memoryview('Q') handed to Python
+    PyObject *request_args;         // (request_view,), reused for every fill_request() call
 } apb_plugin_data_t;
 
-static apb_plugin_data_t apb_data = {NULL, NULL, NULL};
+static apb_plugin_data_t apb_data = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+
+// Python-visible buffer: the record, then the sim time of the call in the
+// slot after the last field, so fill_request() needs no per-call objects
+typedef struct {
+    apb_request_t request;
+    uint64_t time;
+} apb_request_buf_t;
+
+// Field names and widths in schema order, generated from APB_REQUEST_FIELDS
+#define APB_REQ_NAME_ENTRY(name, width) #name,
+static const char *apb_request_names[APB_REQ_NUM_FIELDS] = {
+    APB_REQUEST_FIELDS(APB_REQ_NAME_ENTRY)
+};
+#undef APB_REQ_NAME_ENTRY
+
+#define APB_REQ_WIDTH_ENTRY(name, width) width,
+static const int apb_request_widths[APB_REQ_NUM_FIELDS] = {
+    APB_REQUEST_FIELDS(APB_REQ_WIDTH_ENTRY)
+};
+#undef APB_REQ_WIDTH_ENTRY
+
+/**
+ * apb_request_setup()
+ * 
+ * Description:
+ *   Sends the request schema to Python (`set_request_schema`) and allocates
+ *   the record buffer that `fill_request()` writes into, together with the
+ *   argument tuple passed on every call.
+ *   Optional: if the driver has no `fill_request`, dpi_get_request() falls
+ *   back to the tuple-based get_transaction().
+ * 
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+static int apb_request_setup(void) {
+    if (!PyObject_HasAttrString(apb_data.module, "fill_request")) {
+        DPI_LOG_INFO("apb_driver has no fill_request(), using tuple requests");
+        return DPI_SUCCESS;
+    }
+
+    PyObject *func_schema = dpi_core_get_function(apb_data.module, "set_request_schema");
+    if (func_schema == NULL) {
+        return DPI_ERROR;
+    }
+
+    // Schema: ((name, width), ...) in record order
+    PyObject *schema = PyTuple_New(APB_REQ_NUM_FIELDS);
+    for (int i = 0; i < APB_REQ_NUM_FIELDS; i++) {
+        PyTuple_SetItem(schema, i, Py_BuildValue("(si)", apb_request_names[i], apb_request_widths[i]));
+    }
+
+    PyObject *pArgs = PyTuple_Pack(1, schema);
+    PyObject *pValue = dpi_core_call_function(func_schema, pArgs);
+    Py_DECREF(pArgs);
+    Py_DECREF(schema);
+    Py_DECREF(func_schema);
+    if (pValue == NULL) {
+        return DPI_ERROR;
+    }
+    Py_DECREF(pValue);
+
+    // One record for the whole run; Python sees it as a list of uint64
+    apb_data.request_buf = PyByteArray_FromStringAndSize(NULL, sizeof(apb_request_buf_t));
+    if (apb_data.request_buf == NULL) {
+        PyErr_Print();
+        return DPI_ERROR;
+    }
+    memset(PyByteArray_AS_STRING(apb_data.request_buf), 0, sizeof(apb_request_buf_t));
+
+    PyObject *raw_view = PyMemoryView_FromObject(apb_data.request_buf);
+    if (raw_view == NULL) {
+        PyErr_Print();
+        return DPI_ERROR;
+    }
+    apb_data.request_view = PyObject_CallMethod(raw_view, "cast", "s", "Q");
+    Py_DECREF(raw_view);
+    if (apb_data.request_view == NULL) {
+        PyErr_Print();
+        return DPI_ERROR;
+    }
+
+    apb_data.request_args = PyTuple_Pack(1, apb_data.request_view);
+    if (apb_data.request_args == NULL) {
+        PyErr_Print();
+        return DPI_ERROR;
+    }
+
+    apb_data.func_fill_request = dpi_core_get_function(apb_data.module, "fill_request");
+    if (apb_data.func_fill_request == NULL) {
+        return DPI_ERROR;
+    }
+
+    DPI_LOG_INFO("APB request record: %d fields, %d bits", APB_REQ_NUM_FIELDS, APB_REQUEST_WIDTH);
+    return DPI_SUCCESS;
+}
+
+/**
+ * apb_request_pack()
+ * 
+ * Description:
+ *   Packs the record into SV packed-vector words (bit 0 = LSB of word 0).
+ *   Like an SV packed struct, the last field lands at bit 0 and the first
+ *   field at the MSB end. Each field is masked to its declared width.
+ */
+static void apb_request_pack(const apb_request_t *rec, uint32_t *words) {
+    const uint64_t *values = (const uint64_t*)rec;
+    int offset = 0;
+
+    memset(words, 0, sizeof(uint32_t) * APB_REQUEST_WORDS);
+
+    for (int i = APB_REQ_NUM_FIELDS - 1; i >= 0; i--) {
+        int width = apb_request_widths[i];
+        uint64_t value = values[i];
+        if (width < 64) {
+            value &= (1ULL << width) - 1;
+        }
+
+        // Write the field 32 bits (or less) at a time
+        for (int done = 0; done < width; ) {
+            int word = (offset + done) / 32;
+            int bit = (offset + done) % 32;
+            int chunk = 32 - bit;
+            if (chunk > width - done) {
+                chunk = width - done;
+            }
+            uint32_t part = (uint32_t)(value >> done);
+            if (chunk < 32) {
+                part &= (1U << chunk) - 1;
+            }
+            words[word] |= part << bit;
+            done += chunk;
+        }
+        offset += width;
+    }
+}
 
 /**
  * apb_init()
@@ -58,6 +225,7 @@ int apb_init(void) {
         DPI_LOG_ERROR("Failed to load apb_driver module from tests/");
         return DPI_ERROR;
     }
+    dpi_mem_add_domain("apb", "./tests");
 
     // Get Python functions
     apb_data.func_get_transaction = dpi_core_get_function(apb_data.module, "get_transaction");
@@ -70,6 +238,18 @@ int apb_init(void) {
         return DPI_ERROR;
     }
 
+    if (apb_request_setup() != DPI_SUCCESS) {
+        return DPI_ERROR;
+    }
+
+    // Older drivers have no op_done(); their sequences never send opcodes
+    apb_data.func_op_done = PyObject_GetAttrString(apb_data.module, "op_done");
+    if (apb_data.func_op_done == NULL || !PyCallable_Check(apb_data.func_op_done)) {
+        PyErr_Clear();
+        Py_XDECREF(apb_data.func_op_done);
+        apb_data.func_op_done = NULL;
+    }
+
     DPI_LOG_INFO("APB plugin initialized successfully");
     return DPI_SUCCESS;
 }
@@ -82,38 +262,120 @@ int apb_init(void) {
  */
 void apb_cleanup(void) {
     DPI_LOG_INFO("Cleaning up APB plugin");
+
+    apb_prefetch_stop();
     
     Py_XDECREF(apb_data.func_get_transaction);
     Py_XDECREF(apb_data.func_send_read_data);
+    Py_XDECREF(apb_data.func_fill_request);
+    Py_XDECREF(apb_data.func_op_done);
+    Py_XDECREF(apb_data.request_args);
+    Py_XDECREF(apb_data.request_view);
+    Py_XDECREF(apb_data.request_buf);
     Py_XDECREF(apb_data.module);
     
     apb_data.func_get_transaction = NULL;
     apb_data.func_send_read_data = NULL;
+    apb_data.func_fill_request = NULL;
+    apb_data.func_op_done = NULL;
+    apb_data.request_args = NULL;
+    apb_data.request_view = NULL;
+    apb_data.request_buf = NULL;
     apb_data.module = NULL;
 }
 
 /**
- * dpi_get_transaction()
+ * apb_call_driver()
  * 
  * Description:
- *   Called by SV driver to fetch the next transaction.
- *   Converts Python tuple -> C integers -> SV output arguments.
+ *   Calls a module-level function of `apb_driver` by name.
+ * 
+ * Returns:
+ *   New reference to the result, or NULL on failure.
+ */
+static PyObject* apb_call_driver(const char *func_name, PyObject *args) {
+    PyObject *func = dpi_core_get_function(apb_data.module, func_name);
+    if (func == NULL) {
+        return NULL;
+    }
+
+    PyObject *result = dpi_core_call_function(func, args);
+    Py_DECREF(func);
+    return result;
+}
+
+/**
+ * apb_reset()
+ * 
+ * Description:
+ *   Called between tests of a session: Python `reset()` drops the sequence;
+ *   the next test loads its own, or the default test (APB_TEST) is loaded on
+ *   first use, as a fresh interpreter would.
+ */
+void apb_reset(void) {
+    apb_prefetch_stop();
+
+    if (apb_data.module == NULL || !PyObject_HasAttrString(apb_data.module, "reset")) {
+        return;
+    }
+
+    DPI_LOG_INFO("Resetting APB plugin");
+    PyObject *pValue = apb_call_driver("reset", NULL);
+    Py_XDECREF(pValue);
+}
+
+/**
+ * dpi_load_test()
+ * 
+ * Description:
+ *   Called by SV to select the Python test for the next sequence.
  * 
  * Args:
- *   time: Current simulation time
- *   is_write, addr, data: Output pointers for transaction details
+ *   test_name: Test module name (e.g., "apb_burst_test")
  * 
  * Returns:
- *   1 if transaction available, 0 if none.
+ *   0 on success, 1 on failure.
  */
-int dpi_get_transaction(dpi_time_t time, int *is_write, int *addr, int *data) {
-    PyObject *pArgs, *pValue;
+int dpi_load_test(const char *test_name) {
+    if (dpi_warm_active()) {
+        return dpi_warm_load_test(test_name) == DPI_SUCCESS ? 0 : 1;
+    }
 
-    if (apb_data.func_get_transaction == NULL) {
+    if (apb_data.module == NULL) {
         DPI_LOG_ERROR("APB plugin not initialized");
-        return 0;
+        return 1;
     }
 
+    dpi_core_enter();
+
+    // Transactions generated ahead belong to the old test
+    apb_prefetch_stop();
+
+    PyObject *pArgs = PyTuple_New(1);
+    PyTuple_SetItem(pArgs, 0, PyUnicode_FromString(test_name));
+    PyObject *pValue = apb_call_driver("load_test", pArgs);
+    Py_DECREF(pArgs);
+
+    int status = (pValue != NULL && PyObject_IsTrue(pValue) == 1) ? 0 : 1;
+    Py_XDECREF(pValue);
+
+    dpi_core_leave();
+    return status;
+}
+
+/**
+ * apb_fetch_transaction()
+ * 
+ * Description:
+ *   Calls Python `get_transaction()` and converts the tuple to C integers.
+ *   GIL must be held.
+ * 
+ * Returns:
+ *   1 if transaction available, 0 if none.
+ */
+static int apb_fetch_transaction(dpi_time_t time, int *is_write, int *addr, int *data) {
+    PyObject *pArgs, *pValue;
+
     // Create arguments tuple (time)
     pArgs = PyTuple_New(1);
     PyTuple_SetItem(pArgs, 0, PyLong_FromLongLong(time));
@@ -122,28 +384,230 @@ int dpi_get_transaction(dpi_time_t time, int *is_write, int *addr, int *data) {
     pValue = dpi_core_call_function(apb_data.func_get_transaction, pArgs);
     Py_DECREF(pArgs);
 
+    int valid = 0;
     if (pValue != NULL) {
         if (pValue == Py_None) {
-            Py_DECREF(pValue);
-            return 0; // No more transactions
+            // No more transactions
+        } else if (!PyTuple_Check(pValue) || PyTuple_Size(pValue) != 3) {
+            // Expected tuple: (is_write, addr, data)
+            DPI_LOG_ERROR("Invalid return value from get_transaction");
+        } else {
+            *is_write = (int)PyLong_AsLong(PyTuple_GetItem(pValue, 0));
+            *addr = (int)PyLong_AsLong(PyTuple_GetItem(pValue, 1));
+            *data = (int)PyLong_AsLong(PyTuple_GetItem(pValue, 2));
+            valid = 1; // Valid transaction
         }
+        Py_DECREF(pValue);
+    }
 
-        // Expected tuple: (is_write, addr, data)
-        if (!PyTuple_Check(pValue) || PyTuple_Size(pValue) != 3) {
-            DPI_LOG_ERROR("Invalid return value from get_transaction");
-            Py_DECREF(pValue);
+    return valid;
+}
+
+/**
+ * apb_prefetch_pop_started()
+ * 
+ * Description:
+ *   Prefetch path shared by both request functions: starts the producer on
+ *   the first request of a sequence, then pops its queue.
+ * 
+ * Returns:
+ *   1 if request available, 0 if none.
+ */
+static int apb_prefetch_pop_started(dpi_time_t time, apb_request_t *rec) {
+    if (!apb_prefetch_active()) {
+        dpi_core_enter();
+        int status = apb_prefetch_start();
+        dpi_core_leave();
+        if (status != DPI_SUCCESS) {
+            return 0;
+        }
+    }
+    return apb_prefetch_pop(time, rec);
+}
+
+/**
+ * dpi_get_transaction()
+ * 
+ * Description:
+ *   Called by SV driver to fetch the next transaction.
+ *   Converts Python tuple -> C integers -> SV output arguments.
+ * 
+ * Args:
+ *   time: Current simulation time
+ *   is_write, addr, data: Output pointers for transaction details
+ * 
+ * Returns:
+ *   1 if transaction available, 0 if none.
+ */
+int dpi_get_transaction(dpi_time_t time, int *is_write, int *addr, int *data) {
+    if (dpi_warm_active()) {
+        return dpi_warm_get_transaction(time, is_write, addr, data);
+    }
+
+    if (apb_data.func_get_transaction == NULL) {
+        DPI_LOG_ERROR("APB plugin not initialized");
+        return 0;
+    }
+
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_DPI, "dpi_get_transaction", time);
+    DPI_MEM_TICK(time);
+
+    int valid;
+    if (apb_prefetch_requested()) {
+        apb_request_t rec;
+        valid = apb_prefetch_pop_started(time, &rec);
+        // The tuple interface cannot carry opcodes: complete them at once
+        while (valid && rec.op != APB_OP_XFER) {
+            apb_prefetch_push_op_done(time, APB_OP_STATUS_UNSUPPORTED, 0);
+            valid = apb_prefetch_pop(time, &rec);
+        }
+        if (valid) {
+            *is_write = (int)rec.is_write;
+            *addr = (int)rec.addr;
+            *data = (int)rec.data;
+        }
+    } else {
+        dpi_core_enter();
+        valid = apb_fetch_transaction(time, is_write, addr, data);
+        dpi_core_leave();
+    }
+
+    DPI_TRACE_END(DPI_TRACE_CAT_DPI, "dpi_get_transaction", time);
+    return valid;
+}
+
+/**
+ * apb_next_request()
+ * 
+ * Description:
+ *   Fetches the next request from Python as an unpacked C record.
+ *   Python fills the preallocated record in place; the call reuses one
+ *   argument tuple and passes the time in the buffer. Falls back to the tuple
+ *   path (get_transaction) in warm mode or when the driver has no
+ *   fill_request(). Shared by dpi_get_request(), the prefetch producer and
+ *   the simulator-free fast_sim executable. GIL must be held.
+ * 
+ * Args:
+ *   time: Current simulation time
+ *   rec: Output record
+ * 
+ * Returns:
+ *   1 if request available, 0 if none.
+ */
+int apb_next_request(dpi_time_t time, apb_request_t *rec) {
+    int valid = 0;
+
+    if (dpi_warm_active() || apb_data.func_fill_request == NULL) {
+        int is_write, addr, data;
+        int got = dpi_warm_active() ? dpi_warm_get_transaction(time, &is_write, &addr, &data)
+                                    : apb_fetch_transaction(time, &is_write, &addr, &data);
+        if (!got) {
             return 0;
         }
+        memset(rec, 0, sizeof(*rec));
+        rec->is_write = (uint64_t)is_write;
+        rec->addr = (uint32_t)addr;
+        rec->data = (uint32_t)data;
+        // Same defaults as APBTransaction: all byte lanes, PPROT 1
+        rec->strobe = is_write ? 0xF : 0;
+        rec->prot = 1;
+        return 1;
+    }
 
-        *is_write = (int)PyLong_AsLong(PyTuple_GetItem(pValue, 0));
-        *addr = (int)PyLong_AsLong(PyTuple_GetItem(pValue, 1));
-        *data = (int)PyLong_AsLong(PyTuple_GetItem(pValue, 2));
+    apb_request_buf_t *buf = (apb_request_buf_t *)PyByteArray_AS_STRING(apb_data.request_buf);
+    buf->time = (uint64_t)time;
 
+    PyObject *pValue = dpi_core_call_function(apb_data.func_fill_request, apb_data.request_args);
+
+    if (pValue != NULL) {
+        valid = PyObject_IsTrue(pValue) == 1;
         Py_DECREF(pValue);
-        return 1; // Valid transaction
     }
 
-    return 0;
+    if (valid) {
+        memcpy(rec, &buf->request, sizeof(*rec));
+    }
+    return valid;
+}
+
+/**
+ * dpi_get_request()
+ * 
+ * Description:
+ *   Called by SV to fetch the next request as a packed record.
+ *   C packs the record from apb_next_request() into the SV vector.
+ * 
+ * Args:
+ *   time: Current simulation time
+ *   request: Output packed vector, APB_REQUEST_WORDS svBitVecVal words
+ * 
+ * Returns:
+ *   1 if request available, 0 if none.
+ */
+int dpi_get_request(dpi_time_t time, uint32_t *request) {
+    apb_request_t rec;
+
+    int valid;
+
+    if (apb_data.module == NULL && !dpi_warm_active()) {
+        DPI_LOG_ERROR("APB plugin not initialized");
+        return 0;
+    }
+
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_DPI, "dpi_get_request", time);
+    DPI_MEM_TICK(time);
+    if (apb_prefetch_requested()) {
+        valid = apb_prefetch_pop_started(time, &rec);
+    } else {
+        dpi_core_enter();
+        valid = apb_next_request(time, &rec);
+        dpi_core_leave();
+    }
+    if (valid) {
+        apb_request_pack(&rec, request);
+    }
+    DPI_TRACE_END(DPI_TRACE_CAT_DPI, "dpi_get_request", time);
+
+    return valid;
+}
+
+/**
+ * dpi_get_request_width()
+ * 
+ * Description:
+ *   Returns the packed width of the request record in bits, so SV can check
+ *   that its `apb_py_req_t` matches `apb_request.h`.
+ */
+int dpi_get_request_width(void) {
+    return APB_REQUEST_WIDTH;
+}
+
+/**
+ * apb_deliver_read_data()
+ * 
+ * Description:
+ *   Calls Python `send_read_data()`. GIL must be held. Used directly by the
+ *   prefetch producer and the fast_sim executable.
+ * 
+ * Args:
+ *   time: Simulation time the read completed
+ *   data: Read data value
+ */
+void apb_deliver_read_data(dpi_time_t time, int data) {
+    PyObject *pArgs, *pValue;
+
+    // Create arguments tuple (time, data)
+    pArgs = PyTuple_New(2);
+    PyTuple_SetItem(pArgs, 0, PyLong_FromLongLong(time));
+    PyTuple_SetItem(pArgs, 1, PyLong_FromUnsignedLong((uint32_t)data));
+
+    // Call Python function
+    pValue = dpi_core_call_function(apb_data.func_send_read_data, pArgs);
+    Py_DECREF(pArgs);
+
+    if (pValue != NULL) {
+        Py_DECREF(pValue);
+    }
 }
 
 /**
@@ -151,29 +615,100 @@ int dpi_get_transaction(dpi_time_t time, int *is_write, int *addr, int *data) {
  * 
  * Description:
  *   Called by SV driver to return read data to Python.
+ *   With prefetch, the data is queued for the producer thread instead.
  * 
  * Args:
  *   time: Current simulation time
  *   data: Read data value
  */
 void dpi_send_read_data(dpi_time_t time, int data) {
-    PyObject *pArgs, *pValue;
+    if (dpi_warm_active()) {
+        dpi_warm_send_read_data(time, data);
+        return;
+    }
 
     if (apb_data.func_send_read_data == NULL) {
         DPI_LOG_ERROR("APB plugin not initialized");
         return;
     }
 
-    // Create arguments tuple (time, data)
-    pArgs = PyTuple_New(2);
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_DPI, "dpi_send_read_data", time);
+
+    if (apb_prefetch_active()) {
+        apb_prefetch_push_read_data(time, data);
+    } else {
+        dpi_core_enter();
+        apb_deliver_read_data(time, data);
+        dpi_core_leave();
+    }
+
+    DPI_TRACE_END(DPI_TRACE_CAT_DPI, "dpi_send_read_data", time);
+}
+
+/**
+ * apb_deliver_op_done()
+ * 
+ * Description:
+ *   Calls Python `op_done()`. GIL must be held. Used directly by the
+ *   prefetch producer and the fast_sim executable.
+ * 
+ * Args:
+ *   time: Simulation time the opcode finished
+ *   status: APB_OP_STATUS_* value
+ *   data: Last value read by a poll, 0 otherwise
+ */
+void apb_deliver_op_done(dpi_time_t time, int status, int data) {
+    if (apb_data.func_op_done == NULL) {
+        return;
+    }
+
+    // Create arguments tuple (time, status, data)
+    PyObject *pArgs = PyTuple_New(3);
     PyTuple_SetItem(pArgs, 0, PyLong_FromLongLong(time));
-    PyTuple_SetItem(pArgs, 1, PyLong_FromLong(data));
+    PyTuple_SetItem(pArgs, 1, PyLong_FromLong(status));
+    PyTuple_SetItem(pArgs, 2, PyLong_FromUnsignedLong((uint32_t)data));
 
-    // Call Python function
-    pValue = dpi_core_call_function(apb_data.func_send_read_data, pArgs);
+    PyObject *pValue = dpi_core_call_function(apb_data.func_op_done, pArgs);
     Py_DECREF(pArgs);
 
     if (pValue != NULL) {
         Py_DECREF(pValue);
     }
 }
+
+/**
+ * dpi_op_done()
+ * 
+ * Description:
+ *   Called by SV once an opcode request (wait, wait-for-reset, poll) has
+ *   finished. With prefetch, the result is queued for the producer thread.
+ *   In warm-start mode requests come through the tuple interface, which
+ *   carries no opcodes, so there is nothing to report.
+ * 
+ * Args:
+ *   time: Current simulation time
+ *   status: APB_OP_STATUS_* value
+ *   data: Last value read by a poll, 0 otherwise
+ */
+void dpi_op_done(dpi_time_t time, int status, int data) {
+    if (dpi_warm_active()) {
+        return;
+    }
+
+    if (apb_data.module == NULL) {
+        DPI_LOG_ERROR("APB plugin not initialized");
+        return;
+    }
+
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_DPI, "dpi_op_done", time);
+
+    if (apb_prefetch_active()) {
+        apb_prefetch_push_op_done(time, status, data);
+    } else {
+        dpi_core_enter();
+        apb_deliver_op_done(time, status, data);
+        dpi_core_leave();
+    }
+
+    DPI_TRACE_END(DPI_TRACE_CAT_DPI, "dpi_op_done", time);
+}
@@ -2,15 +2,34 @@
 #define APB_PLUGIN_H
 
 #include "../../core/dpi_types.h"
+#include "apb_request.h"
 
 // APB Plugin initialization and cleanup
 int apb_init(void);
 void apb_cleanup(void);
+void apb_reset(void);
 
 // DPI-C exported functions for SystemVerilog
 int dpi_get_transaction(dpi_time_t time, int *is_write, int *addr, int *data);
 void dpi_send_read_data(dpi_time_t time, int data);
 
+// Completion of an opcode request (wait, wait-for-reset, poll)
+void dpi_op_done(dpi_time_t time, int status, int data);
+
+// Switch the Python test without restarting the interpreter
+int dpi_load_test(const char *test_name);
+
+// Record-based request path (see apb_request.h)
+// `request` is an svBitVecVal array of APB_REQUEST_WORDS words
+int dpi_get_request(dpi_time_t time, uint32_t *request);
+int dpi_get_request_width(void);
+
+// C-level calls into Python, GIL held (used by the DPI functions, the
+// prefetch producer and fast_sim)
+int apb_next_request(dpi_time_t time, apb_request_t *rec);
+void apb_deliver_read_data(dpi_time_t time, int data);
+void apb_deliver_op_done(dpi_time_t time, int status, int data);
+
 // Plugin registration
 void apb_register_plugin(void);
 
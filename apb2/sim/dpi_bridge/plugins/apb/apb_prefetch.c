@@ -0,0 +1,413 @@
+/*
+ * APB Prefetch - The "Run-Ahead" Producer
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * Normally Python and the simulator take turns: SV asks for transaction N+1
+ * only after N has been driven, and Python computes it while the simulator
+ * waits. With prefetch, a helper thread runs the Python sequence AHEAD of the
+ * simulator and parks the results in a small queue:
+ *
+ *   producer thread:  fill_request() -> fill_request() -> ... -> [queue]
+ *   simulator thread:                 [queue] -> drive N -> drive N+1 -> ...
+ *
+ * `dpi_get_request()` / `dpi_get_transaction()` then just pop the queue, and on
+ * a multi-core host the two halves overlap instead of alternating.
+ *
+ * How to use:
+ *   DPI_APB_PREFETCH=8 sim.py ...          # queue depth (0 or unset = off)
+ *   DPI_APB_PREFETCH_READS=stall|ahead     # feedback rule for reads
+ *
+ * Reads and opcodes (feedback rule):
+ *   Read data and opcode completions (`dpi_op_done`) go back through a second
+ *   queue; the producer hands them to Python `send_read_data()` / `op_done()`
+ *   in order, so callbacks still see every value.
+ *     stall (default) - after generating a read or an opcode, the producer
+ *                       waits until its result is back. Safe for sequences
+ *                       whose next transactions depend on it.
+ *     ahead           - the producer never waits for results. Use it for
+ *                       sequences whose stimulus does not depend on them.
+ *
+ * Things to know:
+ *   - Python sees the sim time of the last transaction SV consumed, since the
+ *     time of a transaction generated ahead is not known yet.
+ *   - The queues are single-producer/single-consumer rings with atomic
+ *     indices; neither side takes a lock. A side that must wait spins briefly,
+ *     then sleeps in short steps. The producer exits once the sequence has
+ *     ended and all its reads are answered, so it does not poll idle.
+ *   - Switching tests or resetting discards transactions generated ahead.
+ *   - Not used in warm-start mode (the worker is already a separate process).
+ */
+
+#include "apb_prefetch.h"
+#include "apb_plugin.h"
+#include "../../core/dpi_core.h"
+#include "../../core/dpi_trace.h"
+#include "../../core/dpi_warm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#define PREFETCH_SPIN_LIMIT 64
+#define PREFETCH_SLEEP_US   20
+
+// One generated transaction, or the end-of-sequence marker
+typedef struct {
+    apb_request_t rec;
+    int end;
+} prefetch_item_t;
+
+// Read data or opcode completion on its way back to Python
+typedef struct {
+    dpi_time_t time;
+    int data;
+    int status;
+    int is_op_done;
+} prefetch_read_t;
+
+typedef struct {
+    pthread_t thread;
+    int active;                         // producer thread running
+    atomic_int stop;
+    atomic_int exited;                  // producer left its loop
+    apb_prefetch_reads_t reads_rule;
+
+    // Producer -> simulator ring
+    prefetch_item_t *items;
+    size_t depth;
+    atomic_size_t item_head;            // next slot the producer writes
+    atomic_size_t item_tail;            // next slot the simulator reads
+    int end_seen;                       // simulator thread only
+
+    // Simulator -> producer ring
+    prefetch_read_t *reads;
+    size_t read_capacity;
+    atomic_size_t read_head;            // next slot the simulator writes
+    atomic_size_t read_tail;            // next slot the producer reads
+
+    atomic_llong sim_time;              // last time seen by the simulator
+
+    // Counters
+    uint64_t produced;                  // producer thread only
+    uint64_t producer_waits;            // producer thread only
+    uint64_t consumer_waits;            // simulator thread only
+} apb_prefetch_t;
+
+static apb_prefetch_t prefetch;
+
+/**
+ * prefetch_backoff()
+ *
+ * Description:
+ *   One wait step: yield for a while, then sleep in short steps.
+ */
+static void prefetch_backoff(unsigned int *spins) {
+    if ((*spins)++ < PREFETCH_SPIN_LIMIT) {
+        sched_yield();
+    } else {
+        usleep(PREFETCH_SLEEP_US);
+    }
+}
+
+/**
+ * apb_prefetch_requested()
+ *
+ * Description:
+ *   Returns non-zero if DPI_APB_PREFETCH asks for a queue and a local
+ *   interpreter is in use.
+ */
+int apb_prefetch_requested(void) {
+    const char *depth = getenv("DPI_APB_PREFETCH");
+    return depth != NULL && atoi(depth) > 0 && !dpi_warm_active();
+}
+
+/**
+ * apb_prefetch_active()
+ *
+ * Description:
+ *   Returns non-zero while a producer thread is running.
+ */
+int apb_prefetch_active(void) {
+    return prefetch.active;
+}
+
+/**
+ * prefetch_deliver_reads()
+ *
+ * Description:
+ *   Producer side: hands all queued read data and opcode completions to
+ *   Python, in order.
+ *
+ * Returns:
+ *   Number of values delivered.
+ */
+static uint64_t prefetch_deliver_reads(void) {
+    size_t tail = atomic_load_explicit(&prefetch.read_tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&prefetch.read_head, memory_order_acquire);
+    uint64_t delivered = 0;
+
+    if (tail == head) {
+        return 0;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    while (tail != head) {
+        prefetch_read_t *r = &prefetch.reads[tail % prefetch.read_capacity];
+        if (r->is_op_done) {
+            apb_deliver_op_done(r->time, r->status, r->data);
+        } else {
+            apb_deliver_read_data(r->time, r->data);
+        }
+        tail++;
+        delivered++;
+        atomic_store_explicit(&prefetch.read_tail, tail, memory_order_release);
+        head = atomic_load_explicit(&prefetch.read_head, memory_order_acquire);
+    }
+    PyGILState_Release(gstate);
+
+    return delivered;
+}
+
+/**
+ * prefetch_thread()
+ *
+ * Description:
+ *   Producer thread body. Generates transactions while there is room in the
+ *   queue and the feedback rule allows it, delivering read data in between.
+ *   After the end of the sequence it delivers the outstanding read data and
+ *   exits; anything arriving later is delivered by apb_prefetch_stop().
+ */
+static void* prefetch_thread(void *arg) {
+    uint64_t reads_issued = 0, reads_done = 0;
+    unsigned int spins = 0;
+    int ended = 0;
+
+    (void)arg;
+
+    while (!atomic_load_explicit(&prefetch.stop, memory_order_acquire)) {
+        reads_done += prefetch_deliver_reads();
+
+        // Nothing left to generate or to wait for: do not poll until stopped
+        if (ended && reads_done >= reads_issued) {
+            break;
+        }
+
+        size_t head = atomic_load_explicit(&prefetch.item_head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit(&prefetch.item_tail, memory_order_acquire);
+        int full = head - tail >= prefetch.depth;
+        int stalled = prefetch.reads_rule == APB_PREFETCH_READS_STALL && reads_done < reads_issued;
+
+        if (ended || full || stalled) {
+            if (!ended) {
+                prefetch.producer_waits++;
+            }
+            prefetch_backoff(&spins);
+            continue;
+        }
+        spins = 0;
+
+        prefetch_item_t *item = &prefetch.items[head % prefetch.depth];
+        dpi_time_t now = (dpi_time_t)atomic_load_explicit(&prefetch.sim_time, memory_order_relaxed);
+
+        PyGILState_STATE gstate = PyGILState_Ensure();
+        DPI_TRACE_BEGIN(DPI_TRACE_CAT_PLUGIN, "prefetch_fill", now);
+        int valid = apb_next_request(now, &item->rec);
+        DPI_TRACE_END(DPI_TRACE_CAT_PLUGIN, "prefetch_fill", now);
+        PyGILState_Release(gstate);
+
+        item->end = !valid;
+        if (valid) {
+            prefetch.produced++;
+            // Reads and opcodes both get exactly one answer from SV
+            if (item->rec.op != APB_OP_XFER || !item->rec.is_write) {
+                reads_issued++;
+            }
+        } else {
+            ended = 1;
+        }
+        atomic_store_explicit(&prefetch.item_head, head + 1, memory_order_release);
+    }
+
+    // Read data that arrived before the stop still belongs to the test
+    prefetch_deliver_reads();
+    atomic_store_explicit(&prefetch.exited, 1, memory_order_release);
+    return NULL;
+}
+
+/**
+ * apb_prefetch_start()
+ *
+ * Description:
+ *   Allocates the queues and starts the producer thread. Called by the
+ *   simulator thread (GIL held) on the first request of a sequence.
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+int apb_prefetch_start(void) {
+    const char *rule = getenv("DPI_APB_PREFETCH_READS");
+    const char *depth = getenv("DPI_APB_PREFETCH");
+
+    if (prefetch.active) {
+        return DPI_SUCCESS;
+    }
+
+    memset(&prefetch, 0, sizeof(prefetch));
+    prefetch.depth = (size_t)atoi(depth ? depth : "0");
+    prefetch.reads_rule = (rule != NULL && strcmp(rule, "ahead") == 0)
+                          ? APB_PREFETCH_READS_AHEAD : APB_PREFETCH_READS_STALL;
+
+    // Every queued item can turn into one read, plus the one being generated
+    prefetch.read_capacity = 2 * prefetch.depth + 2;
+
+    prefetch.items = calloc(prefetch.depth, sizeof(prefetch_item_t));
+    prefetch.reads = calloc(prefetch.read_capacity, sizeof(prefetch_read_t));
+    if (prefetch.depth == 0 || prefetch.items == NULL || prefetch.reads == NULL) {
+        DPI_LOG_ERROR("Cannot allocate APB prefetch queue");
+        free(prefetch.items);
+        free(prefetch.reads);
+        return DPI_ERROR;
+    }
+
+    // The producer needs the GIL while SV is busy simulating
+    dpi_core_enable_threads();
+
+    if (pthread_create(&prefetch.thread, NULL, prefetch_thread, NULL) != 0) {
+        DPI_LOG_ERROR("Failed to create APB prefetch thread");
+        free(prefetch.items);
+        free(prefetch.reads);
+        return DPI_ERROR;
+    }
+
+    prefetch.active = 1;
+    DPI_LOG_INFO("APB prefetch started (depth %zu, reads: %s)", prefetch.depth,
+                 prefetch.reads_rule == APB_PREFETCH_READS_STALL ? "stall" : "ahead");
+    return DPI_SUCCESS;
+}
+
+/**
+ * apb_prefetch_stop()
+ *
+ * Description:
+ *   Stops the producer, delivers outstanding read data and discards
+ *   transactions generated ahead. Called by the simulator thread (GIL held)
+ *   before a test switch, a reset or cleanup.
+ */
+void apb_prefetch_stop(void) {
+    if (!prefetch.active) {
+        return;
+    }
+
+    atomic_store_explicit(&prefetch.stop, 1, memory_order_release);
+
+    // The producer may be waiting for the GIL: let it go while we join
+    Py_BEGIN_ALLOW_THREADS
+    pthread_join(prefetch.thread, NULL);
+    Py_END_ALLOW_THREADS
+
+    // The producer exits once the sequence has ended and every read was
+    // answered; feedback SV sent after that is delivered from here
+    prefetch_deliver_reads();
+
+    size_t unused = atomic_load(&prefetch.item_head) - atomic_load(&prefetch.item_tail);
+    DPI_LOG_INFO("APB prefetch stopped: %llu generated, %zu discarded, "
+                 "simulator waited %llu times, producer waited %llu times",
+                 (unsigned long long)prefetch.produced, unused,
+                 (unsigned long long)prefetch.consumer_waits,
+                 (unsigned long long)prefetch.producer_waits);
+
+    free(prefetch.items);
+    free(prefetch.reads);
+    prefetch.items = NULL;
+    prefetch.reads = NULL;
+    prefetch.active = 0;
+}
+
+/**
+ * apb_prefetch_pop()
+ *
+ * Description:
+ *   Simulator side: takes the next generated transaction, waiting if the
+ *   producer has not caught up. Does not need the GIL.
+ *
+ * Args:
+ *   time: Current simulation time (passed on to the producer)
+ *   rec: Output record
+ *
+ * Returns:
+ *   1 if request available, 0 at the end of the sequence.
+ */
+int apb_prefetch_pop(dpi_time_t time, apb_request_t *rec) {
+    unsigned int spins = 0;
+
+    if (prefetch.end_seen) {
+        return 0;
+    }
+
+    atomic_store_explicit(&prefetch.sim_time, (long long)time, memory_order_relaxed);
+
+    size_t tail = atomic_load_explicit(&prefetch.item_tail, memory_order_relaxed);
+    if (atomic_load_explicit(&prefetch.item_head, memory_order_acquire) == tail) {
+        prefetch.consumer_waits++;
+        while (atomic_load_explicit(&prefetch.item_head, memory_order_acquire) == tail) {
+            prefetch_backoff(&spins);
+        }
+    }
+
+    prefetch_item_t *item = &prefetch.items[tail % prefetch.depth];
+    int valid = !item->end;
+    if (valid) {
+        *rec = item->rec;
+    } else {
+        prefetch.end_seen = 1;
+    }
+    atomic_store_explicit(&prefetch.item_tail, tail + 1, memory_order_release);
+
+    return valid;
+}
+
+/**
+ * prefetch_push_feedback()
+ *
+ * Description:
+ *   Simulator side: queues read data or an opcode completion for the
+ *   producer to hand to Python. Does not need the GIL.
+ */
+static void prefetch_push_feedback(dpi_time_t time, int data, int status, int is_op_done) {
+    unsigned int spins = 0;
+    size_t head = atomic_load_explicit(&prefetch.read_head, memory_order_relaxed);
+
+    while (head - atomic_load_explicit(&prefetch.read_tail, memory_order_acquire) >= prefetch.read_capacity) {
+        // More answers than requests, and nobody left to drain them
+        if (atomic_load_explicit(&prefetch.exited, memory_order_acquire)) {
+            DPI_LOG_WARN("APB prefetch: unexpected read data or opcode completion dropped");
+            return;
+        }
+        prefetch_backoff(&spins);
+    }
+
+    prefetch_read_t *r = &prefetch.reads[head % prefetch.read_capacity];
+    r->time = time;
+    r->data = data;
+    r->status = status;
+    r->is_op_done = is_op_done;
+    atomic_store_explicit(&prefetch.read_head, head + 1, memory_order_release);
+}
+
+/**
+ * apb_prefetch_push_read_data() / apb_prefetch_push_op_done()
+ *
+ * Description:
+ *   Simulator side of dpi_send_read_data() / dpi_op_done() with prefetch.
+ */
+void apb_prefetch_push_read_data(dpi_time_t time, int data) {
+    prefetch_push_feedback(time, data, 0, 0);
+}
+
+void apb_prefetch_push_op_done(dpi_time_t time, int status, int data) {
+    prefetch_push_feedback(time, data, status, 1);
+}
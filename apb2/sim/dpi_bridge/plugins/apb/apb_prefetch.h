@@ -0,0 +1,24 @@
+#ifndef APB_PREFETCH_H
+#define APB_PREFETCH_H
+
+#include "../../core/dpi_types.h"
+#include "apb_request.h"
+
+// Feedback rules for reads (DPI_APB_PREFETCH_READS)
+typedef enum {
+    APB_PREFETCH_READS_STALL,   // stop generating after a read until its data is back
+    APB_PREFETCH_READS_AHEAD    // keep generating; read data is delivered when it arrives
+} apb_prefetch_reads_t;
+
+// Producer lifecycle (simulator thread, GIL held)
+int apb_prefetch_requested(void);
+int apb_prefetch_active(void);
+int apb_prefetch_start(void);
+void apb_prefetch_stop(void);
+
+// Simulator side of the queues (no GIL needed)
+int apb_prefetch_pop(dpi_time_t time, apb_request_t *rec);
+void apb_prefetch_push_read_data(dpi_time_t time, int data);
+void apb_prefetch_push_op_done(dpi_time_t time, int status, int data);
+
+#endif // APB_PREFETCH_H
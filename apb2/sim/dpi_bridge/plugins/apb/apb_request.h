@@ -0,0 +1,81 @@
+/*
+ * APB Request Record - Schema
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * This is the ONE place where the fields of a Python -> SV request are declared.
+ * Think of it as the packed struct definition of the request, written once:
+ *   - the C struct below is generated from it,
+ *   - the field names/widths are handed to Python at init (`set_request_schema`),
+ *   - the bit packing into the SV `bit [N-1:0]` vector is derived from it.
+ *
+ * The SV side declares the matching `apb_py_req_t` packed struct in
+ * `apb_python_seq.sv`; the sequence checks `$bits(apb_py_req_t)` against
+ * `dpi_get_request_width()` at start-up so a mismatch is caught immediately.
+ *
+ * Adding a field: add one X(...) line here and the same field to
+ * `apb_py_req_t` (same order). No new DPI function, no new tuple shape.
+ *
+ * Order: the FIRST field is the MSB end of the packed struct, like SV.
+ * Width: 1..64 bits per field. Wider buses use several fields (data_lo/data_hi).
+ *
+ * Opcodes (`op` field, APB_OP_* below; `apb_py_op_e` in SV, `APBOpcode` in Python):
+ *   XFER        - one APB transfer (is_write, addr, data, strobe, prot, delay)
+ *   WAIT_CLOCKS - idle for `delay` PCLK cycles
+ *   WAIT_RESET  - wait until PRESETn is deasserted, `timeout` cycles max (0 = none)
+ *   POLL        - read `addr` until (rdata & mask) == (data & mask), idling
+ *                 `delay` cycles between reads, `timeout` cycles max (0 = none)
+ * Everything except XFER runs entirely in SV and is reported back to Python
+ * once, when it finishes, through `dpi_op_done()` -> Python `op_done()`.
+ */
+
+#ifndef APB_REQUEST_H
+#define APB_REQUEST_H
+
+#include <stdint.h>
+
+//      name      width
+#define APB_REQUEST_FIELDS(X) \
+    X(is_write,   1)  \
+    X(addr,       64) \
+    X(data,       64) \
+    X(strobe,     8)  \
+    X(prot,       3)  \
+    X(delay,      32) \
+    X(op,         4)  \
+    X(mask,       64) \
+    X(timeout,    32)
+
+// Values of the `op` field
+#define APB_OP_XFER         0
+#define APB_OP_WAIT_CLOCKS  1
+#define APB_OP_WAIT_RESET   2
+#define APB_OP_POLL         3
+
+// Status reported by dpi_op_done()
+#define APB_OP_STATUS_DONE         0
+#define APB_OP_STATUS_TIMEOUT      1
+#define APB_OP_STATUS_UNSUPPORTED  2
+
+// Field indices: APB_REQ_FIELD_is_write, APB_REQ_FIELD_addr, ...
+#define APB_REQ_ENUM(name, width) APB_REQ_FIELD_##name,
+typedef enum {
+    APB_REQUEST_FIELDS(APB_REQ_ENUM)
+    APB_REQ_NUM_FIELDS
+} apb_request_field_t;
+#undef APB_REQ_ENUM
+
+// C view of the record: one 64-bit slot per field, in schema order.
+// Python fills exactly this layout through a memoryview of format 'Q'.
+#define APB_REQ_MEMBER(name, width) uint64_t name;
+typedef struct {
+    APB_REQUEST_FIELDS(APB_REQ_MEMBER)
+} apb_request_t;
+#undef APB_REQ_MEMBER
+
+// Total packed width in bits and in 32-bit svBitVecVal words
+#define APB_REQ_ADD_WIDTH(name, width) + (width)
+#define APB_REQUEST_WIDTH (0 APB_REQUEST_FIELDS(APB_REQ_ADD_WIDTH))
+#define APB_REQUEST_WORDS ((APB_REQUEST_WIDTH + 31) / 32)
+
+#endif // APB_REQUEST_H
@@ -0,0 +1,427 @@
+/*
+ * Generic Capture - The "Flight Recorder"
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * Parsing every `sprint()` string in Python while the simulation runs makes the
+ * simulator wait for the analysis. For heavy analyses that do not have to run
+ * inline, capture mode skips Python entirely: `dpi_send_object()` just appends
+ * the object to a binary log, and the analysis runs afterwards on all cores
+ * with `parsers/capture_replay.py`.
+ *
+ * How to use:
+ *   DPI_CAPTURE_DIR=capture sim.py ...            # record
+ *   python3 dpi_bridge/plugins/generic/parsers/capture_replay.py capture
+ *
+ * Optional: DPI_CAPTURE_SEGMENT_MB (default 64) sets the segment size.
+ *
+ * Files in DPI_CAPTURE_DIR (host byte order, same machine or same endianness):
+ *   capture_NNNNN.seg  Segment: 16-byte header (magic "DPICAP01", uint32
+ *                      version, uint32 segment number), then records:
+ *                      uint32 tag id, uint32 payload length, int64 sim time,
+ *                      payload bytes (the sprint() string, no terminator).
+ *   capture_NNNNN.idx  Index of that segment, one 24-byte entry per record:
+ *                      uint64 file offset, int64 sim time, uint32 tag id,
+ *                      uint32 payload length.
+ *   tags.tsv           "id<TAB>tag" lines, appended when a tag is first seen.
+ *
+ * All files are append-only and written through large stdio buffers; a new
+ * segment starts when the current one reaches the size limit, so each segment
+ * can be processed independently. A new run replaces the previous capture in
+ * the same directory. C-side filters still apply before capture.
+ *
+ * If a write fails (e.g. disk full), the error is logged once, the files are
+ * closed and later objects are dropped, not parsed inline. The files stay
+ * readable up to the failure; records still in the stdio buffer (up to
+ * 1 MB) may be lost, and capture_replay.py stops at the truncated record.
+ */
+
+#include "generic_capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CAPTURE_PATH_LEN     1024
+#define CAPTURE_BUFFER_SIZE  (1 << 20)
+#define CAPTURE_DEFAULT_MB   64
+
+typedef struct {
+    char dir[CAPTURE_PATH_LEN];
+    uint64_t segment_limit;     // bytes per segment
+
+    FILE *seg;                  // current segment
+    FILE *idx;                  // current segment index
+    FILE *tags;                 // tag table
+    char *seg_buf;
+    char *idx_buf;
+    int seg_no;
+    uint64_t seg_bytes;
+    uint64_t seg_records;
+
+    char **tag_names;           // tag id -> name
+    int num_tags;
+    int tag_capacity;
+    int last_tag;               // lookup cache: objects come in runs of one tag
+
+    uint64_t records;
+    uint64_t bytes;
+
+    int failed;                 // a write failed: capture stopped, objects are dropped
+    uint64_t dropped;
+} generic_capture_t;
+
+static generic_capture_t capture = {{0}, 0, NULL, NULL, NULL, NULL, NULL, 0, 0, 0, NULL, 0, 0, 0, 0, 0, 0, 0};
+
+/**
+ * generic_capture_active()
+ *
+ * Description:
+ *   Returns non-zero while objects are being captured instead of parsed,
+ *   also after a failed write (they are then dropped).
+ */
+int generic_capture_active(void) {
+    return capture.seg != NULL || capture.failed;
+}
+
+/**
+ * capture_remove_old()
+ *
+ * Description:
+ *   Deletes segments, indexes and the tag table of a previous run so that
+ *   a shorter run does not leave stale segments behind.
+ */
+static void capture_remove_old(void) {
+    char path[CAPTURE_PATH_LEN + 64];
+    struct dirent *entry;
+
+    DIR *dir = opendir(capture.dir);
+    if (dir == NULL) {
+        return;
+    }
+
+    while ((entry = readdir(dir)) != NULL) {
+        const char *name = entry->d_name;
+        size_t len = strlen(name);
+        int is_segment = strncmp(name, "capture_", 8) == 0 && len > 4 &&
+                         (strcmp(name + len - 4, ".seg") == 0 || strcmp(name + len - 4, ".idx") == 0);
+        if (is_segment || strcmp(name, "tags.tsv") == 0) {
+            snprintf(path, sizeof(path), "%s/%s", capture.dir, name);
+            unlink(path);
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * capture_close_segment()
+ *
+ * Description:
+ *   Flushes and closes the current segment and its index.
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR if buffered data could not be written
+ */
+static int capture_close_segment(void) {
+    int status = DPI_SUCCESS;
+
+    if (capture.seg != NULL) {
+        if (fclose(capture.seg) != 0) {
+            status = DPI_ERROR;
+        }
+        capture.seg = NULL;
+    }
+    if (capture.idx != NULL) {
+        if (fclose(capture.idx) != 0) {
+            status = DPI_ERROR;
+        }
+        capture.idx = NULL;
+    }
+    return status;
+}
+
+/**
+ * capture_fail()
+ *
+ * Description:
+ *   Stops the capture after a failed write: logs the error (once, since
+ *   nothing is written afterwards) and closes the segment.
+ *
+ * Args:
+ *   what: File that could not be written, for the message
+ */
+static void capture_fail(const char *what) {
+    int err = errno;
+
+    capture_close_segment();
+    capture.failed = 1;
+    DPI_LOG_ERROR("Object capture stopped, cannot write %s in %s: %s; further objects are dropped",
+                  what, capture.dir, strerror(err));
+}
+
+/**
+ * capture_open_segment()
+ *
+ * Description:
+ *   Starts segment number `seg_no`: opens the .seg/.idx pair with large
+ *   buffers and writes the segment header.
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+static int capture_open_segment(int seg_no) {
+    char path[CAPTURE_PATH_LEN + 64];
+    char header[16];
+    uint32_t version = GENERIC_CAPTURE_VERSION;
+    uint32_t number = (uint32_t)seg_no;
+
+    snprintf(path, sizeof(path), "%s/capture_%05d.seg", capture.dir, seg_no);
+    capture.seg = fopen(path, "wb");
+    snprintf(path, sizeof(path), "%s/capture_%05d.idx", capture.dir, seg_no);
+    capture.idx = fopen(path, "wb");
+
+    if (capture.seg == NULL || capture.idx == NULL) {
+        DPI_LOG_ERROR("Cannot create capture segment %s: %s", path, strerror(errno));
+        capture_close_segment();
+        return DPI_ERROR;
+    }
+
+    setvbuf(capture.seg, capture.seg_buf, _IOFBF, CAPTURE_BUFFER_SIZE);
+    setvbuf(capture.idx, capture.idx_buf, _IOFBF, CAPTURE_BUFFER_SIZE / 4);
+
+    memcpy(header, GENERIC_CAPTURE_MAGIC, 8);
+    memcpy(header + 8, &version, 4);
+    memcpy(header + 12, &number, 4);
+    if (fwrite(header, 1, sizeof(header), capture.seg) != sizeof(header)) {
+        DPI_LOG_ERROR("Cannot write capture segment header: %s", strerror(errno));
+        capture_close_segment();
+        return DPI_ERROR;
+    }
+
+    capture.seg_no = seg_no;
+    capture.seg_bytes = sizeof(header);
+    capture.seg_records = 0;
+    return DPI_SUCCESS;
+}
+
+/**
+ * generic_capture_open()
+ *
+ * Description:
+ *   Enables capture mode if DPI_CAPTURE_DIR is set: creates the directory,
+ *   removes an older capture and opens the first segment.
+ *
+ * Returns:
+ *   DPI_SUCCESS (also when capture is not requested) or DPI_ERROR
+ */
+int generic_capture_open(void) {
+    const char *dir = getenv("DPI_CAPTURE_DIR");
+    const char *segment_mb = getenv("DPI_CAPTURE_SEGMENT_MB");
+    char path[CAPTURE_PATH_LEN + 64];
+
+    if (dir == NULL || dir[0] == '\0' || generic_capture_active()) {
+        return DPI_SUCCESS;
+    }
+
+    if (strlen(dir) >= sizeof(capture.dir)) {
+        DPI_LOG_ERROR("DPI_CAPTURE_DIR path too long");
+        return DPI_ERROR;
+    }
+    strcpy(capture.dir, dir);
+
+    if (mkdir(capture.dir, 0755) != 0 && errno != EEXIST) {
+        DPI_LOG_ERROR("Cannot create capture directory %s: %s", capture.dir, strerror(errno));
+        return DPI_ERROR;
+    }
+    capture_remove_old();
+
+    long mb = segment_mb ? strtol(segment_mb, NULL, 0) : CAPTURE_DEFAULT_MB;
+    capture.segment_limit = (uint64_t)(mb > 0 ? mb : CAPTURE_DEFAULT_MB) << 20;
+
+    capture.seg_buf = malloc(CAPTURE_BUFFER_SIZE);
+    capture.idx_buf = malloc(CAPTURE_BUFFER_SIZE / 4);
+    snprintf(path, sizeof(path), "%s/tags.tsv", capture.dir);
+    capture.tags = fopen(path, "w");
+
+    if (capture.seg_buf == NULL || capture.idx_buf == NULL || capture.tags == NULL ||
+        capture_open_segment(0) != DPI_SUCCESS) {
+        DPI_LOG_ERROR("Cannot start object capture in %s", capture.dir);
+        generic_capture_close();
+        return DPI_ERROR;
+    }
+
+    capture.records = 0;
+    capture.bytes = 0;
+    DPI_LOG_INFO("Capturing objects to %s (%llu MB segments)", capture.dir,
+                 (unsigned long long)(capture.segment_limit >> 20));
+    return DPI_SUCCESS;
+}
+
+/**
+ * capture_tag_id()
+ *
+ * Description:
+ *   Returns the id of a tag, assigning the next id (and appending it to
+ *   tags.tsv) the first time the tag is seen. Returns -1 (after logging) if
+ *   the tag cannot be stored.
+ */
+static int capture_tag_id(const char *tag) {
+    if (capture.num_tags > 0 && strcmp(capture.tag_names[capture.last_tag], tag) == 0) {
+        return capture.last_tag;
+    }
+
+    for (int i = 0; i < capture.num_tags; i++) {
+        if (strcmp(capture.tag_names[i], tag) == 0) {
+            capture.last_tag = i;
+            return i;
+        }
+    }
+
+    if (capture.num_tags == capture.tag_capacity) {
+        int capacity = capture.tag_capacity ? capture.tag_capacity * 2 : 16;
+        char **names = realloc(capture.tag_names, (size_t)capacity * sizeof(char*));
+        if (names == NULL) {
+            DPI_LOG_ERROR("Out of memory for capture tag '%s'", tag);
+            return -1;
+        }
+        capture.tag_names = names;
+        capture.tag_capacity = capacity;
+    }
+
+    char *name = strdup(tag);
+    if (name == NULL) {
+        DPI_LOG_ERROR("Out of memory for capture tag '%s'", tag);
+        return -1;
+    }
+    capture.tag_names[capture.num_tags] = name;
+    capture.last_tag = capture.num_tags++;
+
+    // Rare, so flush at once: the tag table is complete even after a crash
+    if (fprintf(capture.tags, "%d\t%s\n", capture.last_tag, tag) < 0 || fflush(capture.tags) != 0) {
+        capture_fail("tags.tsv");
+        return -1;
+    }
+    return capture.last_tag;
+}
+
+/**
+ * generic_capture_write()
+ *
+ * Description:
+ *   Appends one object record to the current segment and its index entry,
+ *   starting a new segment first if this record would exceed the limit.
+ *
+ * Args:
+ *   time: Sim time (GENERIC_TIME_UNKNOWN if the caller has none)
+ *   tag: Object tag
+ *   object_str: sprint() string
+ */
+void generic_capture_write(dpi_time_t time, const char *tag, const char *object_str) {
+    char header[16];
+    char entry[24];
+
+    if (capture.seg == NULL) {
+        if (capture.failed) {
+            capture.dropped++;
+        }
+        return;
+    }
+
+    // Every path below that does not store the object counts it as dropped
+    int tag_id = capture_tag_id(tag);
+    if (tag_id < 0) {
+        capture.dropped++;
+        return;
+    }
+
+    uint32_t id = (uint32_t)tag_id;
+    uint32_t length = (uint32_t)strlen(object_str);
+    uint64_t record_size = sizeof(header) + length;
+
+    if (capture.seg_records > 0 && capture.seg_bytes + record_size > capture.segment_limit) {
+        if (capture_close_segment() != DPI_SUCCESS) {
+            capture_fail("the last segment");
+            capture.dropped++;
+            return;
+        }
+        if (capture_open_segment(capture.seg_no + 1) != DPI_SUCCESS) {
+            capture.failed = 1;
+            capture.dropped++;
+            return;
+        }
+    }
+
+    uint64_t offset = capture.seg_bytes;
+
+    memcpy(header, &id, 4);
+    memcpy(header + 4, &length, 4);
+    memcpy(header + 8, &time, 8);
+    if (fwrite(header, 1, sizeof(header), capture.seg) != sizeof(header) ||
+        fwrite(object_str, 1, length, capture.seg) != length) {
+        capture_fail("a segment");
+        capture.dropped++;
+        return;
+    }
+
+    memcpy(entry, &offset, 8);
+    memcpy(entry + 8, &time, 8);
+    memcpy(entry + 16, &id, 4);
+    memcpy(entry + 20, &length, 4);
+    if (fwrite(entry, 1, sizeof(entry), capture.idx) != sizeof(entry)) {
+        capture_fail("an index");
+        capture.dropped++;
+        return;
+    }
+
+    capture.seg_bytes += record_size;
+    capture.seg_records++;
+    capture.records++;
+    capture.bytes += record_size;
+}
+
+/**
+ * generic_capture_close()
+ *
+ * Description:
+ *   Flushes and closes all capture files and prints a summary.
+ */
+void generic_capture_close(void) {
+    int was_active = generic_capture_active();
+
+    if (capture_close_segment() != DPI_SUCCESS) {
+        capture_fail("the last segment");
+    }
+    if (capture.tags != NULL) {
+        fclose(capture.tags);
+        capture.tags = NULL;
+    }
+
+    if (was_active) {
+        DPI_LOG_INFO("Captured %llu objects (%llu bytes, %d tags) in %d segment(s) under %s",
+                     (unsigned long long)capture.records, (unsigned long long)capture.bytes,
+                     capture.num_tags, capture.seg_no + 1, capture.dir);
+    }
+    if (capture.dropped > 0) {
+        DPI_LOG_ERROR("Capture incomplete: %llu objects dropped",
+                      (unsigned long long)capture.dropped);
+    }
+
+    for (int i = 0; i < capture.num_tags; i++) {
+        free(capture.tag_names[i]);
+    }
+    free(capture.tag_names);
+    free(capture.seg_buf);
+    free(capture.idx_buf);
+
+    capture.tag_names = NULL;
+    capture.num_tags = 0;
+    capture.tag_capacity = 0;
+    capture.last_tag = 0;
+    capture.seg_buf = NULL;
+    capture.idx_buf = NULL;
+    capture.failed = 0;
+    capture.dropped = 0;
+}
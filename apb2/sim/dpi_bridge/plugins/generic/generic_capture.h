@@ -0,0 +1,18 @@
+#ifndef GENERIC_CAPTURE_H
+#define GENERIC_CAPTURE_H
+
+#include "../../core/dpi_types.h"
+
+// Segment file header and record layout, shared with parsers/capture_replay.py
+#define GENERIC_CAPTURE_MAGIC   "DPICAP01"
+#define GENERIC_CAPTURE_VERSION 1
+
+// Capture lifecycle (enabled by DPI_CAPTURE_DIR)
+int generic_capture_open(void);
+int generic_capture_active(void);
+void generic_capture_close(void);
+
+// Append one object record to the current segment
+void generic_capture_write(dpi_time_t time, const char *tag, const char *object_str);
+
+#endif // GENERIC_CAPTURE_H
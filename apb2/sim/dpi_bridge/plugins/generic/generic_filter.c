@@ -0,0 +1,532 @@
+/*
+ * Generic Filter - The "Gatekeeper"
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * Creating a Python string, calling a parser and building a dict costs far more
+ * than the SV `sprint()` itself. When you only care about a few address windows
+ * or a 1-in-1000 sample, most of that work is thrown away.
+ *
+ * This file lets Python install filter rules ONCE (at init), which are then
+ * evaluated in plain C for every `dpi_send_object()` call. Objects that do not
+ * pass never become Python objects.
+ *
+ * How it works:
+ * 1. Python side: `object_receiver.py` may define `get_filters()` returning a
+ *    list of dicts. Each dict is one rule; all keys are optional:
+ *      tag        - only objects with this tag ("*" = any tag)
+ *      field      - field name to look up in the sprint() string
+ *      min, max   - inclusive range the field value must fall in
+ *      t_start    - first sim time (inclusive) the rule applies to
+ *      t_end      - last sim time (inclusive) the rule applies to
+ *                   (both in the `$time` units of the SV caller, i.e. its
+ *                   timescale: 500 us is 500000 at 1ns)
+ *      every      - rate sampling: deliver 1 in N matches
+ *      reservoir  - keep K uniformly chosen matches, delivered at the end
+ *                   (at most 1000000)
+ *
+ * 2. C side (this file):
+ *    - Rules are checked in order, like a firewall: the first rule whose
+ *      predicates all match decides what happens to the object.
+ *    - Objects that match no rule are dropped.
+ *    - If `get_filters()` is missing or returns an empty list, everything passes.
+ *
+ * 3. At the end of the run, hit/drop counters are printed for every rule.
+ */
+
+#include "generic_filter.h"
+#include "../../core/dpi_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define FILTER_NAME_LEN 64
+#define FILTER_MAX_RESERVOIR 1000000
+
+// One filter rule installed by Python
+typedef struct {
+    char tag[FILTER_NAME_LEN];      // "" = any tag
+    char field[FILTER_NAME_LEN];    // "" = no field predicate
+    uint64_t field_min;
+    uint64_t field_max;
+    dpi_time_t t_start;             // GENERIC_TIME_UNKNOWN = unbounded
+    dpi_time_t t_end;               // GENERIC_TIME_UNKNOWN = unbounded
+    uint64_t every;                 // 0 or 1 = deliver all matches
+    int reservoir;                  // 0 = no reservoir
+
+    // Reservoir storage (tag + payload copies)
+    char **res_tags;
+    char **res_objs;
+    int res_count;
+
+    // Counters
+    uint64_t hits;                  // objects matching all predicates
+    uint64_t passed;                // objects delivered (or retained)
+    uint64_t res_lost;              // reservoir copies that failed (out of memory)
+} generic_filter_rule_t;
+
+typedef struct {
+    generic_filter_rule_t *rules;
+    int count;
+    uint64_t total;                 // objects seen
+    uint64_t unmatched;             // objects dropped by "no rule matched"
+    uint64_t rng_state;             // xorshift state for reservoir sampling
+} generic_filter_table_t;
+
+static generic_filter_table_t filter_table = {NULL, 0, 0, 0, 0};
+
+/**
+ * filter_rand()
+ *
+ * Description:
+ *   xorshift64 generator. Seeded with a constant so that reservoir samples
+ *   are reproducible from run to run (same stimulus -> same sample).
+ */
+static uint64_t filter_rand(void) {
+    uint64_t x = filter_table.rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    filter_table.rng_state = x;
+    return x;
+}
+
+/**
+ * dict_get_u64() / dict_get_str()
+ *
+ * Description:
+ *   Read an optional key from a rule dict. Leave `out` untouched if missing.
+ */
+static int dict_get_u64(PyObject *dict, const char *key, uint64_t *out) {
+    PyObject *value = PyDict_GetItemString(dict, key); // Borrowed reference
+    if (value == NULL || value == Py_None) {
+        return DPI_SUCCESS;
+    }
+
+    // Rejects negative values instead of wrapping them (every=-1 -> 2^64-1)
+    unsigned long long v = PyLong_AsUnsignedLongLong(value);
+    if (PyErr_Occurred()) {
+        PyErr_Print();
+        DPI_LOG_ERROR("Filter key '%s' must be a non-negative integer", key);
+        return DPI_ERROR;
+    }
+
+    *out = (uint64_t)v;
+    return DPI_SUCCESS;
+}
+
+static int dict_get_str(PyObject *dict, const char *key, char *out, size_t size) {
+    PyObject *value = PyDict_GetItemString(dict, key); // Borrowed reference
+    if (value == NULL || value == Py_None) {
+        return DPI_SUCCESS;
+    }
+
+    const char *s = PyUnicode_AsUTF8(value);
+    if (s == NULL) {
+        PyErr_Print();
+        DPI_LOG_ERROR("Filter key '%s' must be a string", key);
+        return DPI_ERROR;
+    }
+
+    snprintf(out, size, "%s", s);
+    return DPI_SUCCESS;
+}
+
+/**
+ * parse_rule()
+ *
+ * Description:
+ *   Converts one Python rule dict into a C rule.
+ */
+static int parse_rule(PyObject *dict, generic_filter_rule_t *rule) {
+    uint64_t t_start = (uint64_t)GENERIC_TIME_UNKNOWN;
+    uint64_t t_end = (uint64_t)GENERIC_TIME_UNKNOWN;
+    uint64_t reservoir = 0;
+
+    if (!PyDict_Check(dict)) {
+        DPI_LOG_ERROR("Each filter rule must be a dict");
+        return DPI_ERROR;
+    }
+
+    memset(rule, 0, sizeof(*rule));
+    rule->field_max = UINT64_MAX;
+
+    if (dict_get_str(dict, "tag", rule->tag, sizeof(rule->tag)) != DPI_SUCCESS ||
+        dict_get_str(dict, "field", rule->field, sizeof(rule->field)) != DPI_SUCCESS ||
+        dict_get_u64(dict, "min", &rule->field_min) != DPI_SUCCESS ||
+        dict_get_u64(dict, "max", &rule->field_max) != DPI_SUCCESS ||
+        dict_get_u64(dict, "t_start", &t_start) != DPI_SUCCESS ||
+        dict_get_u64(dict, "t_end", &t_end) != DPI_SUCCESS ||
+        dict_get_u64(dict, "every", &rule->every) != DPI_SUCCESS ||
+        dict_get_u64(dict, "reservoir", &reservoir) != DPI_SUCCESS) {
+        return DPI_ERROR;
+    }
+
+    if (strcmp(rule->tag, "*") == 0) {
+        rule->tag[0] = '\0';
+    }
+    if (reservoir > FILTER_MAX_RESERVOIR) {
+        DPI_LOG_ERROR("Filter reservoir of %llu objects exceeds the limit of %d",
+                      (unsigned long long)reservoir, FILTER_MAX_RESERVOIR);
+        return DPI_ERROR;
+    }
+
+    rule->t_start = (dpi_time_t)t_start;
+    rule->t_end = (dpi_time_t)t_end;
+    rule->reservoir = (int)reservoir;
+
+    if (rule->reservoir > 0) {
+        rule->res_tags = (char**)calloc(rule->reservoir, sizeof(char*));
+        rule->res_objs = (char**)calloc(rule->reservoir, sizeof(char*));
+        if (rule->res_tags == NULL || rule->res_objs == NULL) {
+            DPI_LOG_ERROR("Failed to allocate reservoir of %d objects", rule->reservoir);
+            return DPI_ERROR;
+        }
+    }
+
+    return DPI_SUCCESS;
+}
+
+/**
+ * generic_filter_load()
+ *
+ * Description:
+ *   Calls the optional `get_filters()` function of the receiver module and
+ *   builds the C rule table from the returned list of dicts.
+ *
+ * Args:
+ *   module: The loaded `object_receiver` module
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+int generic_filter_load(PyObject *module) {
+    generic_filter_free();
+    filter_table.rng_state = 0x9E3779B97F4A7C15ULL;
+
+    // get_filters() is optional: without it every object is passed through
+    if (!PyObject_HasAttrString(module, "get_filters")) {
+        DPI_LOG_INFO("No get_filters() in receiver, C-side filtering disabled");
+        return DPI_SUCCESS;
+    }
+
+    PyObject *func = dpi_core_get_function(module, "get_filters");
+    if (func == NULL) {
+        return DPI_ERROR;
+    }
+
+    PyObject *rules = dpi_core_call_function(func, NULL);
+    Py_DECREF(func);
+    if (rules == NULL) {
+        return DPI_ERROR;
+    }
+
+    if (rules == Py_None) {
+        Py_DECREF(rules);
+        return DPI_SUCCESS;
+    }
+
+    PyObject *seq = PySequence_Fast(rules, "get_filters() must return a list");
+    Py_DECREF(rules);
+    if (seq == NULL) {
+        PyErr_Print();
+        return DPI_ERROR;
+    }
+
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    if (n > 0) {
+        filter_table.rules = (generic_filter_rule_t*)calloc(n, sizeof(generic_filter_rule_t));
+        if (filter_table.rules == NULL) {
+            DPI_LOG_ERROR("Failed to allocate filter table");
+            Py_DECREF(seq);
+            return DPI_ERROR;
+        }
+    }
+
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (parse_rule(PySequence_Fast_GET_ITEM(seq, i), &filter_table.rules[i]) != DPI_SUCCESS) {
+            DPI_LOG_ERROR("Invalid filter rule #%zd", i);
+            filter_table.count = (int)i + 1; // Free what was allocated so far
+            generic_filter_free();
+            Py_DECREF(seq);
+            return DPI_ERROR;
+        }
+        filter_table.count = (int)i + 1;
+    }
+
+    Py_DECREF(seq);
+    DPI_LOG_INFO("Installed %d C-side object filters", filter_table.count);
+    return DPI_SUCCESS;
+}
+
+/**
+ * find_field_value()
+ *
+ * Description:
+ *   Extracts `<field>: <value>` from a UVM line printer string without
+ *   creating any Python objects. Mirrors `UVMObjectParser.parse_field()`.
+ *   Understands 'h, 'd, 'o, 'b, 0x and plain decimal values.
+ *
+ * Returns:
+ *   1 if the field was found and parsed, 0 otherwise.
+ */
+static int find_field_value(const char *str, const char *field, uint64_t *value) {
+    size_t len = strlen(field);
+    const char *p = str;
+
+    while ((p = strstr(p, field)) != NULL) {
+        // Must be a whole word followed by ':'
+        int start_ok = (p == str) || !(isalnum((unsigned char)p[-1]) || p[-1] == '_');
+        const char *q = p + len;
+        if (!start_ok || *q != ':') {
+            p += len;
+            continue;
+        }
+
+        q++;
+        while (*q == ' ' || *q == '\t') {
+            q++;
+        }
+
+        int base = 10;
+        if (q[0] == '\'') {
+            switch (tolower((unsigned char)q[1])) {
+                case 'h': base = 16; break;
+                case 'd': base = 10; break;
+                case 'o': base = 8;  break;
+                case 'b': base = 2;  break;
+                default: return 0;
+            }
+            q += 2;
+        } else if (q[0] == '0' && (q[1] == 'x' || q[1] == 'X')) {
+            base = 16;
+            q += 2;
+        }
+
+        char *end;
+        unsigned long long v = strtoull(q, &end, base);
+        if (end == q) {
+            return 0;
+        }
+
+        *value = (uint64_t)v;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * rule_matches()
+ *
+ * Description:
+ *   Evaluates all predicates of one rule (tag, time window, field range).
+ */
+static int rule_matches(const generic_filter_rule_t *rule, const char *tag,
+                        const char *object_str, dpi_time_t time) {
+    if (rule->tag[0] != '\0' && strcmp(rule->tag, tag) != 0) {
+        return 0;
+    }
+
+    // Objects without a sim time never match a time-windowed rule
+    if (rule->t_start != GENERIC_TIME_UNKNOWN || rule->t_end != GENERIC_TIME_UNKNOWN) {
+        if (time == GENERIC_TIME_UNKNOWN) {
+            return 0;
+        }
+        if (rule->t_start != GENERIC_TIME_UNKNOWN && time < rule->t_start) {
+            return 0;
+        }
+        if (rule->t_end != GENERIC_TIME_UNKNOWN && time > rule->t_end) {
+            return 0;
+        }
+    }
+
+    if (rule->field[0] != '\0') {
+        uint64_t value;
+        if (!find_field_value(object_str, rule->field, &value)) {
+            return 0;
+        }
+        if (value < rule->field_min || value > rule->field_max) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * reservoir_offer()
+ *
+ * Description:
+ *   Algorithm R: after N matches, every match has the same K/N chance of
+ *   being in the reservoir. Payloads are copied because SV owns the strings.
+ *   If a copy fails the object is skipped (not counted as passed) and the
+ *   slot keeps its previous sample.
+ */
+static void reservoir_offer(generic_filter_rule_t *rule, const char *tag, const char *object_str) {
+    int slot;
+
+    if (rule->res_count < rule->reservoir) {
+        slot = rule->res_count;
+    } else {
+        uint64_t j = filter_rand() % rule->passed;
+        if (j >= (uint64_t)rule->reservoir) {
+            return;
+        }
+        slot = (int)j;
+    }
+
+    char *tag_copy = strdup(tag);
+    char *obj_copy = strdup(object_str);
+    if (tag_copy == NULL || obj_copy == NULL) {
+        free(tag_copy);
+        free(obj_copy);
+        if (rule->res_lost++ == 0) {
+            DPI_LOG_ERROR("Out of memory for reservoir sample of tag '%s'", tag);
+        }
+        rule->passed--;
+        return;
+    }
+
+    if (slot == rule->res_count) {
+        rule->res_count++;
+    } else {
+        free(rule->res_tags[slot]);
+        free(rule->res_objs[slot]);
+    }
+    rule->res_tags[slot] = tag_copy;
+    rule->res_objs[slot] = obj_copy;
+}
+
+/**
+ * generic_filter_check()
+ *
+ * Description:
+ *   Decides whether an object should be forwarded to Python right now.
+ *   Reservoir rules retain the object instead and return 0.
+ *
+ * Args:
+ *   tag: Object tag
+ *   object_str: sprint() string
+ *   time: Current simulation time, or GENERIC_TIME_UNKNOWN
+ *
+ * Returns:
+ *   1 to deliver now, 0 to drop (or retain).
+ */
+int generic_filter_check(const char *tag, const char *object_str, dpi_time_t time) {
+    if (filter_table.count == 0) {
+        return 1;
+    }
+
+    filter_table.total++;
+
+    for (int i = 0; i < filter_table.count; i++) {
+        generic_filter_rule_t *rule = &filter_table.rules[i];
+        if (!rule_matches(rule, tag, object_str, time)) {
+            continue;
+        }
+
+        rule->hits++;
+
+        // Rate sampling: keep the 1st, (N+1)th, (2N+1)th ... match
+        if (rule->every > 1 && ((rule->hits - 1) % rule->every) != 0) {
+            return 0;
+        }
+        rule->passed++;
+
+        if (rule->reservoir > 0) {
+            reservoir_offer(rule, tag, object_str);
+            return 0;
+        }
+        return 1;
+    }
+
+    filter_table.unmatched++;
+    return 0;
+}
+
+/**
+ * generic_filter_flush()
+ *
+ * Description:
+ *   Hands all reservoir samples to Python. Called once before cleanup.
+ */
+void generic_filter_flush(generic_deliver_fn deliver) {
+    for (int i = 0; i < filter_table.count; i++) {
+        generic_filter_rule_t *rule = &filter_table.rules[i];
+        for (int j = 0; j < rule->res_count; j++) {
+            deliver(rule->res_tags[j], rule->res_objs[j]);
+            free(rule->res_tags[j]);
+            free(rule->res_objs[j]);
+            rule->res_tags[j] = NULL;
+            rule->res_objs[j] = NULL;
+        }
+        rule->res_count = 0;
+    }
+}
+
+/**
+ * generic_filter_report()
+ *
+ * Description:
+ *   Prints hit/pass/drop counters for every rule.
+ */
+void generic_filter_report(void) {
+    if (filter_table.count == 0) {
+        return;
+    }
+
+    uint64_t delivered = 0;
+    DPI_LOG_INFO("Object filter report: %llu objects seen", (unsigned long long)filter_table.total);
+    for (int i = 0; i < filter_table.count; i++) {
+        generic_filter_rule_t *rule = &filter_table.rules[i];
+
+        // Reservoir rules only deliver the K objects they kept
+        uint64_t rule_delivered = rule->passed;
+        if (rule->reservoir > 0 && rule_delivered > (uint64_t)rule->reservoir) {
+            rule_delivered = (uint64_t)rule->reservoir;
+        }
+        delivered += rule_delivered;
+
+        DPI_LOG_INFO("  rule #%d tag=%s field=%s: hits=%llu delivered=%llu dropped=%llu%s",
+                     i,
+                     rule->tag[0] ? rule->tag : "*",
+                     rule->field[0] ? rule->field : "-",
+                     (unsigned long long)rule->hits,
+                     (unsigned long long)rule_delivered,
+                     (unsigned long long)(rule->hits - rule_delivered),
+                     rule->reservoir > 0 ? " (reservoir)" : "");
+        if (rule->res_lost > 0) {
+            DPI_LOG_ERROR("  rule #%d: %llu reservoir samples lost (out of memory)",
+                          i, (unsigned long long)rule->res_lost);
+        }
+    }
+    DPI_LOG_INFO("  unmatched=%llu delivered=%llu",
+                 (unsigned long long)filter_table.unmatched,
+                 (unsigned long long)delivered);
+}
+
+/**
+ * generic_filter_free()
+ *
+ * Description:
+ *   Releases the rule table and any retained reservoir payloads.
+ */
+void generic_filter_free(void) {
+    for (int i = 0; i < filter_table.count; i++) {
+        generic_filter_rule_t *rule = &filter_table.rules[i];
+        for (int j = 0; j < rule->res_count; j++) {
+            free(rule->res_tags[j]);
+            free(rule->res_objs[j]);
+        }
+        free(rule->res_tags);
+        free(rule->res_objs);
+    }
+
+    free(filter_table.rules);
+    filter_table.rules = NULL;
+    filter_table.count = 0;
+    filter_table.total = 0;
+    filter_table.unmatched = 0;
+}
@@ -0,0 +1,21 @@
+#ifndef GENERIC_FILTER_H
+#define GENERIC_FILTER_H
+
+#include "../../core/dpi_types.h"
+
+// Sim time value used when the caller does not know the current time
+#define GENERIC_TIME_UNKNOWN ((dpi_time_t)-1)
+
+// Callback used to hand retained (reservoir) objects to Python at the end
+typedef void (*generic_deliver_fn)(const char *tag, const char *object_str);
+
+// Filter table lifecycle
+int generic_filter_load(PyObject *module);
+void generic_filter_flush(generic_deliver_fn deliver);
+void generic_filter_report(void);
+void generic_filter_free(void);
+
+// Returns 1 if the object should be delivered to Python now, 0 otherwise
+int generic_filter_check(const char *tag, const char *object_str, dpi_time_t time);
+
+#endif // GENERIC_FILTER_H
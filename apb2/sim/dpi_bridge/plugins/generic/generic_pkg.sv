@@ -8,6 +8,7 @@
  * Usage:
  *   import generic_pkg::*;
  *   dpi_send_object("my_tag", my_obj.sprint(printer));
+ *   dpi_send_timed_object($time, "my_tag", my_obj.sprint(printer));
  */
 package generic_pkg;
 
@@ -16,4 +17,7 @@ package generic_pkg;
     // object_str: Serialized string representation of the object
     import "DPI-C" context function void dpi_send_object(input string tag, input string object_str);
 
+    // Same as dpi_send_object, with sim time so time-window filters can apply
+    import "DPI-C" context function void dpi_send_timed_object(input longint sim_time, input string tag, input string object_str);
+
 endpackage
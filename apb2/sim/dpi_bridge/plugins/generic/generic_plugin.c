@@ -20,13 +20,28 @@
  *    - The `receive_object` function looks at the "tag".
  *    - It uses a regex parser (like `apb_parser.py`) to convert the string back to a Python dict.
  * 
+ * 4. Filtering (optional, see `generic_filter.c`):
+ *    - If `object_receiver.py` defines `get_filters()`, the rules it returns are
+ *      checked in C before any Python object is created.
+ *    - Use `dpi_send_timed_object($time, ...)` so sim-time windows can be applied.
+ * 
+ * 5. Capture (optional, see `generic_capture.c`):
+ *    - With DPI_CAPTURE_DIR set, objects are appended to binary log segments
+ *      instead of being parsed; `parsers/capture_replay.py` parses them after
+ *      the run on all cores.
+ * 
  * Why use this?
  * - You NEVER have to recompile this C code again.
  * - To add AXI support, you just write a Python parser.
  */
 
 #include "generic_plugin.h"
+#include "generic_filter.h"
+#include "generic_capture.h"
 #include "../../core/dpi_core.h"
+#include "../../core/dpi_mem.h"
+#include "../../core/dpi_trace.h"
+#include "../../core/dpi_warm.h"
 #include <stdio.h>
 
 // Generic Plugin private data
@@ -37,6 +52,38 @@ typedef struct {
 
 static generic_plugin_data_t generic_data = {NULL, NULL};
 
+/**
+ * generic_deliver()
+ * 
+ * Description:
+ *   Calls `receive_object(tag, object_str)` in Python.
+ */
+static void generic_deliver(const char* tag, const char* object_str) {
+    // Create arguments tuple (tag, object_str)
+    PyObject *pArgs = PyTuple_New(2);
+    PyTuple_SetItem(pArgs, 0, PyUnicode_FromString(tag));
+    PyTuple_SetItem(pArgs, 1, PyUnicode_FromString(object_str));
+
+    // Call Python function
+    PyObject *pValue = dpi_core_call_function(generic_data.func_receive_object, pArgs);
+    Py_DECREF(pArgs);
+
+    if (pValue != NULL) {
+        Py_DECREF(pValue);
+    }
+}
+
+/**
+ * generic_capture_deliver()
+ * 
+ * Description:
+ *   Capture-mode stand-in for generic_deliver(), used for reservoir samples
+ *   (their capture time is not kept).
+ */
+static void generic_capture_deliver(const char* tag, const char* object_str) {
+    generic_capture_write(GENERIC_TIME_UNKNOWN, tag, object_str);
+}
+
 /**
  * generic_init()
  * 
@@ -57,6 +104,7 @@ int generic_init(void) {
         DPI_LOG_ERROR("Failed to load object_receiver module from dpi_bridge/plugins/generic/parsers/");
         return DPI_ERROR;
     }
+    dpi_mem_add_domain("generic", "./dpi_bridge/plugins/generic/parsers");
 
     // Get Python function
     generic_data.func_receive_object = dpi_core_get_function(generic_data.module, "receive_object");
@@ -64,6 +112,16 @@ int generic_init(void) {
         return DPI_ERROR;
     }
 
+    // Install C-side filters requested by Python (optional)
+    if (generic_filter_load(generic_data.module) != DPI_SUCCESS) {
+        return DPI_ERROR;
+    }
+
+    // Log objects for offline parsing instead of parsing them now (optional)
+    if (generic_capture_open() != DPI_SUCCESS) {
+        return DPI_ERROR;
+    }
+
     DPI_LOG_INFO("Generic plugin initialized successfully");
     return DPI_SUCCESS;
 }
@@ -76,6 +134,16 @@ int generic_init(void) {
  */
 void generic_cleanup(void) {
     DPI_LOG_INFO("Cleaning up Generic plugin");
+
+    // Deliver reservoir samples while Python is still alive, then report
+    if (generic_capture_active()) {
+        generic_filter_flush(generic_capture_deliver);
+    } else if (generic_data.func_receive_object != NULL) {
+        generic_filter_flush(generic_deliver);
+    }
+    generic_filter_report();
+    generic_filter_free();
+    generic_capture_close();
     
     Py_XDECREF(generic_data.func_receive_object);
     Py_XDECREF(generic_data.module);
@@ -84,33 +152,81 @@ void generic_cleanup(void) {
     generic_data.module = NULL;
 }
 
+/**
+ * generic_reset()
+ * 
+ * Description:
+ *   Called between tests of a session: delivers and reports the finished
+ *   test's reservoir samples, then reinstalls the filters with fresh counters.
+ */
+void generic_reset(void) {
+    if (generic_data.func_receive_object == NULL) {
+        return;
+    }
+
+    DPI_LOG_INFO("Resetting Generic plugin");
+    generic_filter_flush(generic_capture_active() ? generic_capture_deliver : generic_deliver);
+    generic_filter_report();
+
+    if (generic_filter_load(generic_data.module) != DPI_SUCCESS) {
+        DPI_LOG_ERROR("Failed to reinstall object filters");
+    }
+}
+
 /**
  * dpi_send_object()
  * 
  * Description:
  *   DPI-C exported function called from SystemVerilog.
  *   Sends a serialized object string to Python.
+ *   Sim time is unknown, so time-windowed filter rules never match.
  * 
  * Args:
  *   tag: Identifier string (e.g., "apb_xtn", "axi_txn") used by Python to select parser.
  *   object_str: The string representation of the object (e.g., from uvm_object::sprint()).
  */
 void dpi_send_object(const char* tag, const char* object_str) {
+    dpi_send_timed_object(GENERIC_TIME_UNKNOWN, tag, object_str);
+}
+
+/**
+ * dpi_send_timed_object()
+ * 
+ * Description:
+ *   Same as dpi_send_object(), with the current simulation time so that
+ *   sim-time window filters can be evaluated.
+ * 
+ * Args:
+ *   time: Current simulation time
+ *   tag: Identifier string used by Python to select parser.
+ *   object_str: The string representation of the object.
+ */
+void dpi_send_timed_object(dpi_time_t time, const char* tag, const char* object_str) {
+    if (dpi_warm_active()) {
+        dpi_warm_send_object(time, tag, object_str);
+        return;
+    }
+
     if (generic_data.func_receive_object == NULL) {
         DPI_LOG_ERROR("Generic plugin not initialized");
         return;
     }
 
-    // Create arguments tuple (tag, object_str)
-    PyObject *pArgs = PyTuple_New(2);
-    PyTuple_SetItem(pArgs, 0, PyUnicode_FromString(tag));
-    PyTuple_SetItem(pArgs, 1, PyUnicode_FromString(object_str));
-
-    // Call Python function
-    PyObject *pValue = dpi_core_call_function(generic_data.func_receive_object, pArgs);
-    Py_DECREF(pArgs);
+    DPI_TRACE_BEGIN(DPI_TRACE_CAT_DPI, "dpi_send_object", time == GENERIC_TIME_UNKNOWN ? DPI_TRACE_TIME_LAST : time);
+    dpi_core_enter();
+    if (time != GENERIC_TIME_UNKNOWN) {
+        DPI_MEM_TICK(time);
+    }
 
-    if (pValue != NULL) {
-        Py_DECREF(pValue);
+    // Filtered objects never reach Python; captured ones reach it after the run
+    if (generic_filter_check(tag, object_str, time)) {
+        if (generic_capture_active()) {
+            generic_capture_write(time, tag, object_str);
+        } else {
+            generic_deliver(tag, object_str);
+        }
     }
+
+    dpi_core_leave();
+    DPI_TRACE_END(DPI_TRACE_CAT_DPI, "dpi_send_object", DPI_TRACE_TIME_LAST);
 }
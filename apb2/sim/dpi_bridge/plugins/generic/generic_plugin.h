@@ -6,9 +6,12 @@
 // Plugin lifecycle
 int generic_init(void);
 void generic_cleanup(void);
+void generic_reset(void);
 
 // DPI-C functions
 // Send a UVM object string with a tag to Python
 void dpi_send_object(const char* tag, const char* object_str);
+// Same as dpi_send_object(), with sim time for time-windowed filters
+void dpi_send_timed_object(dpi_time_t time, const char* tag, const char* object_str);
 
 #endif // GENERIC_PLUGIN_H
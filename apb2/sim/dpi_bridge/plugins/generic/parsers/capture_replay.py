@@ -0,0 +1,245 @@
+"""
+Capture Replay - Offline Parsing of Captured Objects
+
+Parses the segments written by the generic plugin in capture mode
+(DPI_CAPTURE_DIR, see generic_capture.c) with the same parsers that
+object_receiver uses during simulation. Each segment goes to its own worker
+process, so the analysis scales across all cores after the run.
+
+Usage (from the sim/ directory):
+    DPI_CAPTURE_DIR=capture sim.py ...
+    python3 dpi_bridge/plugins/generic/parsers/capture_replay.py capture
+    python3 dpi_bridge/plugins/generic/parsers/capture_replay.py capture \\
+        --jobs 16 --tag apb_xtn_uvm --t-start 0 --t-end 500000 --jsonl parsed
+
+As a library:
+    from capture_replay import replay
+    results = replay("capture", handler=my_handler)   # my_handler(tag, time, data)
+"""
+
+import argparse
+import collections
+import glob
+import json
+import multiprocessing
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from object_receiver import parse_object
+
+# Must match generic_capture.h / generic_capture.c (host byte order)
+MAGIC = b"DPICAP01"
+VERSION = 1
+SEGMENT_HEADER = struct.Struct("=8sII")
+RECORD_HEADER = struct.Struct("=IIq")
+INDEX_ENTRY = struct.Struct("=QqII")
+
+# Sim time of objects sent without one (dpi_send_object)
+TIME_UNKNOWN = -1
+
+
+def load_tags(capture_dir):
+    """
+    Read the tag table of a capture.
+
+    Args:
+        capture_dir: Directory given as DPI_CAPTURE_DIR
+
+    Returns:
+        dict of tag id -> tag name
+    """
+    tags = {}
+    with open(os.path.join(capture_dir, "tags.tsv")) as f:
+        for line in f:
+            tag_id, _, name = line.rstrip("\n").partition("\t")
+            tags[int(tag_id)] = name
+    return tags
+
+
+def read_segment(seg_path, t_start=None, t_end=None):
+    """
+    Iterate over the records of one segment.
+
+    Without a time window the segment is read sequentially. With one, the
+    index selects the records in the window and only those are read.
+
+    Args:
+        seg_path: Path of a capture_NNNNN.seg file
+        t_start, t_end: Optional inclusive sim-time window
+
+    Yields:
+        Tuples of (tag_id, sim_time, payload str)
+    """
+    with open(seg_path, "rb") as seg:
+        magic, version, _number = SEGMENT_HEADER.unpack(seg.read(SEGMENT_HEADER.size))
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f"{seg_path}: not a version {VERSION} capture segment")
+
+        if t_start is None and t_end is None:
+            while True:
+                header = seg.read(RECORD_HEADER.size)
+                if len(header) < RECORD_HEADER.size:
+                    return
+                tag_id, length, sim_time = RECORD_HEADER.unpack(header)
+                payload = seg.read(length)
+                if len(payload) < length:
+                    return  # Truncated tail (simulation killed mid-write)
+                yield tag_id, sim_time, payload.decode(errors="replace")
+
+        idx_path = os.path.splitext(seg_path)[0] + ".idx"
+        with open(idx_path, "rb") as idx:
+            index = idx.read()
+        usable = len(index) - len(index) % INDEX_ENTRY.size
+
+        for offset, sim_time, tag_id, length in INDEX_ENTRY.iter_unpack(index[:usable]):
+            if sim_time == TIME_UNKNOWN:
+                continue  # No sim time, so never inside a window
+            if t_start is not None and sim_time < t_start:
+                continue
+            if t_end is not None and sim_time > t_end:
+                continue
+            seg.seek(offset + RECORD_HEADER.size)
+            payload = seg.read(length)
+            if len(payload) < length:
+                return
+            yield tag_id, sim_time, payload.decode(errors="replace")
+
+
+def process_segment(job):
+    """
+    Worker: parse every record of one segment.
+
+    Args:
+        job: Tuple of (seg_path, tags, options dict); options may hold
+             tag, t_start, t_end, jsonl_dir and handler
+
+    Returns:
+        dict with segment, records, per-tag counts, unknown tags, errors,
+        time range and the non-None handler results
+    """
+    seg_path, tags, options = job
+    handler = options.get("handler")
+    want_tag = options.get("tag")
+    result = {
+        "segment": os.path.basename(seg_path),
+        "records": 0,
+        "tags": collections.Counter(),
+        "unknown": 0,
+        "errors": 0,
+        "t_min": None,
+        "t_max": None,
+        "results": [],
+    }
+
+    out = None
+    if options.get("jsonl_dir"):
+        name = os.path.splitext(result["segment"])[0] + ".jsonl"
+        out = open(os.path.join(options["jsonl_dir"], name), "w")
+
+    try:
+        for tag_id, sim_time, payload in read_segment(seg_path, options.get("t_start"), options.get("t_end")):
+            tag = tags.get(tag_id, f"tag{tag_id}")
+            if want_tag is not None and tag != want_tag:
+                continue
+
+            result["records"] += 1
+            result["tags"][tag] += 1
+            if sim_time != TIME_UNKNOWN:
+                result["t_min"] = sim_time if result["t_min"] is None else min(result["t_min"], sim_time)
+                result["t_max"] = sim_time if result["t_max"] is None else max(result["t_max"], sim_time)
+
+            try:
+                _parser, data = parse_object(tag, payload)
+            except Exception:
+                result["errors"] += 1
+                continue
+            if data is None:
+                result["unknown"] += 1
+                continue
+
+            if out is not None:
+                out.write(json.dumps({"tag": tag, "time": sim_time, "data": data}) + "\n")
+            if handler is not None:
+                value = handler(tag, sim_time, data)
+                if value is not None:
+                    result["results"].append(value)
+    finally:
+        if out is not None:
+            out.close()
+
+    return result
+
+
+def replay(capture_dir, handler=None, jobs=None, tag=None, t_start=None, t_end=None, jsonl_dir=None):
+    """
+    Parse a whole capture, one segment per worker process.
+
+    Args:
+        capture_dir: Directory given as DPI_CAPTURE_DIR
+        handler: Optional module-level function handler(tag, time, data),
+                 called in the workers for every parsed object
+        jobs: Worker processes (default: all cores)
+        tag: Only parse objects with this tag
+        t_start, t_end: Optional inclusive sim-time window (uses the indexes)
+        jsonl_dir: Optional directory for one JSON-lines file per segment
+
+    Returns:
+        List of per-segment result dicts (see process_segment), in segment order
+    """
+    segments = sorted(glob.glob(os.path.join(capture_dir, "capture_*.seg")))
+    if not segments:
+        return []
+
+    tags = load_tags(capture_dir)
+    if jsonl_dir:
+        os.makedirs(jsonl_dir, exist_ok=True)
+
+    options = {"handler": handler, "tag": tag, "t_start": t_start, "t_end": t_end, "jsonl_dir": jsonl_dir}
+    work = [(seg, tags, options) for seg in segments]
+
+    jobs = min(jobs or os.cpu_count() or 1, len(segments))
+    if jobs == 1:
+        return [process_segment(job) for job in work]
+
+    with multiprocessing.Pool(jobs) as pool:
+        return pool.map(process_segment, work, chunksize=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Parse captured UVM objects on all cores")
+    parser.add_argument("capture_dir", help="Directory given as DPI_CAPTURE_DIR")
+    parser.add_argument("--jobs", "-j", type=int, default=None, help="Worker processes (default: all cores)")
+    parser.add_argument("--tag", default=None, help="Only parse objects with this tag")
+    parser.add_argument("--t-start", type=int, default=None, help="First sim time (inclusive)")
+    parser.add_argument("--t-end", type=int, default=None, help="Last sim time (inclusive)")
+    parser.add_argument("--jsonl", default=None, help="Write parsed objects to DIR/capture_NNNNN.jsonl")
+    args = parser.parse_args()
+
+    results = replay(args.capture_dir, jobs=args.jobs, tag=args.tag,
+                     t_start=args.t_start, t_end=args.t_end, jsonl_dir=args.jsonl)
+    if not results:
+        print(f"[Replay] No capture segments in {args.capture_dir}")
+        return 1
+
+    totals = collections.Counter()
+    records = unknown = errors = 0
+    for result in results:
+        span = "" if result["t_min"] is None else f" t={result['t_min']}..{result['t_max']}"
+        print(f"[Replay] {result['segment']}: {result['records']} objects{span}")
+        totals.update(result["tags"])
+        records += result["records"]
+        unknown += result["unknown"]
+        errors += result["errors"]
+
+    print(f"[Replay] {records} objects in {len(results)} segment(s), "
+          f"{unknown} with no parser, {errors} parse errors")
+    for tag, count in totals.most_common():
+        print(f"[Replay]   {tag}: {count}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
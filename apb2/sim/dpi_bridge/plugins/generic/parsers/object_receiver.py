@@ -1,6 +1,52 @@
 import sys
 from apb_parser import APBTransactionParser
 
+# C-side filter rules, installed once by the generic plugin at init.
+# Objects that match no rule are dropped in C and never reach receive_object().
+# Leave empty to receive every object. Times are in the $time units of the SV
+# caller (t_end 500000 = 500 us at a 1ns timescale). Example:
+#   FILTERS = [
+#       {"tag": "apb_xtn_uvm", "field": "apb_address", "min": 0x1000, "max": 0x1FFF},
+#       {"tag": "apb_xtn_uvm", "t_start": 0, "t_end": 500000, "every": 1000},
+#       {"tag": "*", "reservoir": 16},
+#   ]
+FILTERS = []
+
+def get_filters():
+    """
+    Called once from the C generic plugin to install object filters.
+    
+    Returns:
+        list of dicts with optional keys: tag, field, min, max,
+        t_start, t_end, every, reservoir
+    """
+    return FILTERS
+
+# Parser class for each tag. Shared by receive_object() during simulation and
+# by capture_replay.py when captured objects are parsed after the run.
+# Add other protocols here, e.g. "axi_txn": AXITransactionParser
+PARSERS = {
+    "apb_xtn_uvm": APBTransactionParser,
+}
+
+def parse_object(tag, object_str):
+    """
+    Parses a UVM object string with the parser registered for its tag.
+    
+    Args:
+        tag (str): Identifier for the object type (e.g., "apb_xtn_uvm")
+        object_str (str): The serialized string from UVM sprint()
+        
+    Returns:
+        Tuple of (parser, data dict), or (None, None) for an unknown tag
+    """
+    parser_class = PARSERS.get(tag)
+    if parser_class is None:
+        return None, None
+    
+    parser = parser_class()
+    return parser, parser.parse(object_str)
+
 def receive_object(tag, object_str):
     """
     Receives a UVM object string from SystemVerilog, parses it, and prints the object.
@@ -13,19 +59,13 @@ def receive_object(tag, object_str):
     sys.stdout.flush()
     
     # Dispatch based on tag
-    if tag == "apb_xtn_uvm":
-        print(f"[Python] Parsing APB Transaction...")
-        parser = APBTransactionParser()
-        data = parser.parse(object_str)
+    if tag in PARSERS:
+        print(f"[Python] Parsing {tag}...")
+        parser, data = parse_object(tag, object_str)
         print(f"[Python] Parsed Data: {data}")
-        parser.print_transaction(data)
+        if hasattr(parser, 'print_transaction'):
+            parser.print_transaction(data)
         sys.stdout.flush()
-    
-    # Add other protocols here
-    # elif tag == "axi_txn":
-    #     parser = AXITransactionParser()
-    #     ...
-        
     else:
         print(f"[Python] Warning: Unknown tag '{tag}'. Raw string: {object_str}")
         sys.stdout.flush()
@@ -0,0 +1,311 @@
+/*
+ * APB Fast Sim - Python Tests Without an HDL Simulator
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * Many Python APB tests only check register semantics. For those, running
+ * `top.sv` with the requester and completer drivers is overkill. This program
+ * plays the part of `apb_python_seq` + the bus + the completer:
+ *
+ *   Python test (apb_driver) --> APB plugin (same C code as the DPI path)
+ *                            --> apb_model.c (native completer + memory map)
+ *                            --> read data back to Python (send_read_data)
+ *
+ * No simulator, no svdpi, no clock edges: one loop iteration is one transfer,
+ * and sim time advances by the cycles the model says the transfer took. The
+ * same test modules run unchanged here and in the full simulation, so this is
+ * a quick pre-check for stimulus and a throughput baseline for the bridge.
+ *
+ * Build (from the sim/ directory):
+ *   gcc -O2 -o apb_fast_sim fast_sim/apb_fast_sim.c fast_sim/apb_model.c \
+ *     dpi_bridge/core/dpi_core.c dpi_bridge/core/dpi_trace.c \
+ *     dpi_bridge/core/dpi_warm.c dpi_bridge/core/dpi_mem.c \
+ *     dpi_bridge/plugins/apb/apb_plugin.c \
+ *     dpi_bridge/plugins/apb/apb_prefetch.c \
+ *     $(python3-config --cflags) -I. $(python3-config --ldflags --embed) -lpthread
+ *
+ * Run (from the sim/ directory, so ./tests is on the Python path):
+ *   ./apb_fast_sim --test apb_burst_test --map fast_sim/apb_memory.map
+ *   ./apb_fast_sim --test apb_random_test --repeat 100000 --quiet
+ *
+ * Differences from the simulation:
+ *   - The completer is a memory, not `apb_completer_driver` (which returns
+ *     random read data after random wait states).
+ *   - PSLVERR is counted and reported; like `apb_python_seq`, the Python test
+ *     only receives read data.
+ *   - Opcodes: WAIT_CLOCKS advances sim time; there is no reset, so
+ *     WAIT_RESET finishes at once; POLL reads the model. Nothing else writes
+ *     the model, so a poll without a timeout that does not match on the
+ *     first read reports TIMEOUT instead of spinning forever.
+ */
+
+#include "apb_model.h"
+#include "../dpi_bridge/core/dpi_core.h"
+#include "../dpi_bridge/core/dpi_mem.h"
+#include "../dpi_bridge/core/dpi_trace.h"
+#include "../dpi_bridge/plugins/apb/apb_plugin.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// PCLK period in sim time units: top.sv toggles the clock every #10
+#define FAST_SIM_DEFAULT_PERIOD 20
+
+// Used when neither --map nor --region is given
+#define FAST_SIM_DEFAULT_REGION "ram 0x0 0x10000 0"
+
+typedef struct {
+    const char *test_name;
+    dpi_time_t period;
+    long repeat;
+    int quiet;
+} fast_sim_options_t;
+
+static double fast_sim_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void fast_sim_usage(const char *prog) {
+    printf("Usage: %s [options]\n"
+           "  --test NAME       Python test module (default: $APB_TEST or apb_basic_test)\n"
+           "  --map FILE        Memory map file (kind base size wait_states per line)\n"
+           "  --region SPEC     Add one region, e.g. ram,0x0,0x10000,0 (repeatable)\n"
+           "  --period N        PCLK period in sim time units (default %d)\n"
+           "  --repeat N        Run the test N times back to back (default 1)\n"
+           "  --quiet           No per-transaction Python logging (for throughput runs)\n",
+           prog, FAST_SIM_DEFAULT_PERIOD);
+}
+
+/**
+ * fast_sim_parse_args()
+ *
+ * Description:
+ *   Fills options and the model's memory map from the command line.
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+static int fast_sim_parse_args(int argc, char **argv, fast_sim_options_t *opts, apb_model_t *model) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--quiet") == 0) {
+            opts->quiet = 1;
+            continue;
+        }
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            fast_sim_usage(argv[0]);
+            exit(0);
+        }
+        if (value == NULL) {
+            DPI_LOG_ERROR("Missing value for %s", arg);
+            return DPI_ERROR;
+        }
+        i++;
+
+        if (strcmp(arg, "--test") == 0) {
+            opts->test_name = value;
+        } else if (strcmp(arg, "--map") == 0) {
+            if (apb_model_load_map(model, value) != DPI_SUCCESS) {
+                return DPI_ERROR;
+            }
+        } else if (strcmp(arg, "--region") == 0) {
+            if (apb_model_parse_region(model, value) != DPI_SUCCESS) {
+                return DPI_ERROR;
+            }
+        } else if (strcmp(arg, "--period") == 0) {
+            opts->period = strtoll(value, NULL, 0);
+        } else if (strcmp(arg, "--repeat") == 0) {
+            opts->repeat = strtol(value, NULL, 0);
+        } else {
+            DPI_LOG_ERROR("Unknown option %s", arg);
+            fast_sim_usage(argv[0]);
+            return DPI_ERROR;
+        }
+    }
+
+    if (opts->period <= 0 || opts->repeat <= 0) {
+        DPI_LOG_ERROR("--period and --repeat must be positive");
+        return DPI_ERROR;
+    }
+
+    if (model->num_regions == 0) {
+        return apb_model_parse_region(model, FAST_SIM_DEFAULT_REGION);
+    }
+    return DPI_SUCCESS;
+}
+
+/**
+ * fast_sim_run_op()
+ *
+ * Description:
+ *   Executes an opcode request (anything but APB_OP_XFER) against the model,
+ *   advancing sim time as apb_python_seq would.
+ *
+ * Args:
+ *   model: Completer model
+ *   req: Opcode request
+ *   period: PCLK period
+ *   sim_time: In/out simulation time
+ *   data: Output, last read data of a poll (0 otherwise)
+ *
+ * Returns:
+ *   APB_OP_STATUS_* value
+ */
+static int fast_sim_run_op(apb_model_t *model, const apb_request_t *req, dpi_time_t period,
+                           dpi_time_t *sim_time, uint32_t *data) {
+    apb_request_t read;
+    apb_response_t rsp;
+    uint64_t cycles = 0;
+
+    *data = 0;
+    switch (req->op) {
+    case APB_OP_WAIT_CLOCKS:
+        *sim_time += (dpi_time_t)req->delay * period;
+        return APB_OP_STATUS_DONE;
+
+    case APB_OP_WAIT_RESET:
+        return APB_OP_STATUS_DONE;
+
+    case APB_OP_POLL:
+        memset(&read, 0, sizeof(read));
+        read.addr = req->addr;
+        read.prot = req->prot;
+        for (;;) {
+            apb_model_transfer(model, &read, &rsp);
+            cycles += rsp.cycles;
+            *sim_time += (dpi_time_t)rsp.cycles * period;
+            *data = rsp.rdata;
+            if ((rsp.rdata & req->mask) == (req->data & req->mask)) {
+                return APB_OP_STATUS_DONE;
+            }
+            if (req->timeout == 0 || cycles >= req->timeout) {
+                return APB_OP_STATUS_TIMEOUT;
+            }
+            cycles += req->delay;
+            *sim_time += (dpi_time_t)req->delay * period;
+        }
+
+    default:
+        return APB_OP_STATUS_UNSUPPORTED;
+    }
+}
+
+int main(int argc, char **argv) {
+    fast_sim_options_t opts = {NULL, FAST_SIM_DEFAULT_PERIOD, 1, 0};
+    apb_model_t model;
+    apb_request_t req;
+    apb_response_t rsp;
+    dpi_time_t sim_time = 0;
+    uint64_t transactions = 0;
+    double python_time = 0.0, model_time = 0.0, setup_time = 0.0;
+    int status = 0;
+
+    apb_model_init(&model);
+    if (fast_sim_parse_args(argc, argv, &opts, &model) != DPI_SUCCESS) {
+        apb_model_free(&model);
+        return 1;
+    }
+
+    // apb_driver picks its test (and apb_reset() its next test) from APB_TEST
+    if (opts.test_name != NULL) {
+        setenv("APB_TEST", opts.test_name, 1);
+    }
+
+    dpi_trace_init();
+    if (dpi_core_init_python() != DPI_SUCCESS) {
+        apb_model_free(&model);
+        return 1;
+    }
+    if (opts.quiet) {
+        PyRun_SimpleString("import os\nsys.stdout = open(os.devnull, 'w')");
+    }
+
+    if (apb_init() != DPI_SUCCESS) {
+        status = 1;
+        goto done;
+    }
+    if (opts.quiet) {
+        // Skip formatting the per-transaction lines, not just their output
+        PyRun_SimpleString("import apb_driver\napb_driver.set_verbose(False)");
+    }
+    dpi_mem_init();
+
+    double start = fast_sim_now();
+
+    for (long run = 0; run < opts.repeat; run++) {
+        if (run > 0) {
+            double t = fast_sim_now();
+            apb_reset();
+            // reset() leaves the sequence to first use; build it here so it counts as setup
+            if (getenv("APB_TEST") != NULL) {
+                dpi_load_test(getenv("APB_TEST"));
+            }
+            setup_time += fast_sim_now() - t;
+        }
+
+        for (;;) {
+            DPI_MEM_TICK(sim_time);
+
+            double t0 = fast_sim_now();
+            int valid = apb_next_request(sim_time, &req);
+            double t1 = fast_sim_now();
+            python_time += t1 - t0;
+            if (!valid) {
+                break;
+            }
+
+            if (req.op != APB_OP_XFER) {
+                uint32_t data;
+                int op_status = fast_sim_run_op(&model, &req, opts.period, &sim_time, &data);
+                double t2 = fast_sim_now();
+                model_time += t2 - t1;
+                apb_deliver_op_done(sim_time, op_status, (int)data);
+                python_time += fast_sim_now() - t2;
+                continue;
+            }
+
+            apb_model_transfer(&model, &req, &rsp);
+            sim_time += (dpi_time_t)rsp.cycles * opts.period;
+            transactions++;
+
+            if (!req.is_write) {
+                double t2 = fast_sim_now();
+                model_time += t2 - t1;
+                apb_deliver_read_data(sim_time, (int)rsp.rdata);
+                python_time += fast_sim_now() - t2;
+            } else {
+                model_time += fast_sim_now() - t1;
+            }
+        }
+    }
+
+    double elapsed = fast_sim_now() - start;
+
+    apb_model_report(&model);
+    DPI_LOG_INFO("Fast sim: %llu transactions, %d run(s), sim time %lld, %.3f s wall",
+                 (unsigned long long)transactions, (int)opts.repeat, (long long)sim_time, elapsed);
+    if (elapsed > 0.0 && transactions > 0) {
+        // Bridge = plugin C code + Python test code, per transfer; the model
+        // alone is the upper bound a cheaper bridge could approach
+        DPI_LOG_INFO("Throughput: %.0f transactions/s overall, %.0f excluding test setup",
+                     (double)transactions / elapsed,
+                     (double)transactions / (elapsed - setup_time));
+        DPI_LOG_INFO("Per transaction: bridge + Python %.0f ns, model %.0f ns; test setup %.3f s",
+                     1e9 * python_time / (double)transactions,
+                     1e9 * model_time / (double)transactions, setup_time);
+    }
+
+done:
+    fflush(stdout);
+    dpi_mem_finalize();
+    apb_cleanup();
+    dpi_core_finalize_python();
+    dpi_trace_finalize();
+    apb_model_free(&model);
+    return status;
+}
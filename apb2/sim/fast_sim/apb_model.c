@@ -0,0 +1,302 @@
+/*
+ * APB Model - Native Completer
+ *
+ * FOR SYSTEMVERILOG ENGINEERS:
+ * ---------------------------
+ * This is a transaction-level stand-in for `apb_completer_driver` plus the
+ * memory behind it. There are no signals and no clock: one call to
+ * `apb_model_transfer()` is one complete APB transfer (setup + access phase),
+ * and it returns how many PCLK cycles that transfer would have taken.
+ *
+ * Memory map:
+ *   A list of regions, each with a kind, base, size and wait states.
+ *     ram   - read/write, byte strobes honored, starts at zero
+ *     rom   - reads return zero-initialized contents, writes get PSLVERR
+ *     error - every access gets PSLVERR (models a decode error window)
+ *   Accesses outside every region also get PSLVERR, like an APB decoder
+ *   routing to a default error slave.
+ *
+ * Map file format (one region per line, `#` starts a comment):
+ *   # kind  base        size      wait_states
+ *   ram     0x00000000  0x10000   0
+ *   rom     0x00010000  0x1000    2
+ *   error   0x000F0000  0x10000   0
+ *
+ * Timing per transfer, in PCLK cycles:
+ *   delay (requester idle cycles) + 1 (setup) + 1 (access) + wait_states
+ *
+ * The data bus is 32 bits wide (PWDATA/PRDATA in apb_if), addresses are
+ * word aligned by the model, PSTRB selects the written byte lanes.
+ */
+
+#include "apb_model.h"
+#include "../dpi_bridge/core/dpi_types.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *region_kind_names[] = {"ram", "rom", "error"};
+
+/**
+ * apb_model_init()
+ *
+ * Description:
+ *   Starts an empty model (no regions: every access is an error).
+ */
+void apb_model_init(apb_model_t *model) {
+    memset(model, 0, sizeof(*model));
+}
+
+/**
+ * apb_model_add_region()
+ *
+ * Description:
+ *   Adds one region to the memory map. Regions must not overlap.
+ *
+ * Args:
+ *   kind: RAM, ROM or ERROR
+ *   base, size: Byte address range [base, base + size)
+ *   wait_states: Extra cycles with PREADY low in the access phase
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+int apb_model_add_region(apb_model_t *model, apb_region_kind_t kind, uint64_t base,
+                         uint64_t size, uint32_t wait_states) {
+    if (model->num_regions >= APB_MODEL_MAX_REGIONS) {
+        DPI_LOG_ERROR("Memory map full (%d regions)", APB_MODEL_MAX_REGIONS);
+        return DPI_ERROR;
+    }
+    if (size == 0 || base + size < base) {
+        DPI_LOG_ERROR("Invalid region 0x%llx + 0x%llx",
+                      (unsigned long long)base, (unsigned long long)size);
+        return DPI_ERROR;
+    }
+
+    for (int i = 0; i < model->num_regions; i++) {
+        const apb_region_t *r = &model->regions[i];
+        if (base < r->base + r->size && r->base < base + size) {
+            DPI_LOG_ERROR("Region 0x%llx overlaps region 0x%llx",
+                          (unsigned long long)base, (unsigned long long)r->base);
+            return DPI_ERROR;
+        }
+    }
+
+    apb_region_t *region = &model->regions[model->num_regions];
+    memset(region, 0, sizeof(*region));
+    region->kind = kind;
+    region->base = base;
+    region->size = size;
+    region->wait_states = wait_states;
+
+    if (kind != APB_REGION_ERROR) {
+        // Whole words, so an unaligned size never reads past the end
+        region->mem = calloc((size + 3) & ~(uint64_t)3, 1);
+        if (region->mem == NULL) {
+            DPI_LOG_ERROR("Cannot allocate %llu bytes for region 0x%llx",
+                          (unsigned long long)size, (unsigned long long)base);
+            return DPI_ERROR;
+        }
+    }
+
+    model->num_regions++;
+    return DPI_SUCCESS;
+}
+
+/**
+ * apb_model_parse_region()
+ *
+ * Description:
+ *   Adds a region from text: "kind base size wait_states", separated by
+ *   spaces or commas (so "ram,0x0,0x10000,0" works on the command line).
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+int apb_model_parse_region(apb_model_t *model, const char *spec) {
+    char buf[256];
+    char kind_name[16];
+    unsigned long long base, size;
+    unsigned int wait_states = 0;
+
+    snprintf(buf, sizeof(buf), "%s", spec);
+    for (char *p = buf; *p; p++) {
+        if (*p == ',') {
+            *p = ' ';
+        }
+    }
+
+    int n = sscanf(buf, "%15s %lli %lli %u", kind_name, &base, &size, &wait_states);
+    if (n < 3) {
+        DPI_LOG_ERROR("Bad region '%s', expected: kind base size [wait_states]", spec);
+        return DPI_ERROR;
+    }
+
+    for (int kind = APB_REGION_RAM; kind <= APB_REGION_ERROR; kind++) {
+        if (strcasecmp(kind_name, region_kind_names[kind]) == 0) {
+            return apb_model_add_region(model, (apb_region_kind_t)kind, base, size, wait_states);
+        }
+    }
+
+    DPI_LOG_ERROR("Unknown region kind '%s' (ram, rom, error)", kind_name);
+    return DPI_ERROR;
+}
+
+/**
+ * apb_model_load_map()
+ *
+ * Description:
+ *   Reads a memory map file, one region per line (see header comment).
+ *
+ * Returns:
+ *   DPI_SUCCESS or DPI_ERROR
+ */
+int apb_model_load_map(apb_model_t *model, const char *path) {
+    char line[256];
+    int line_no = 0;
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        DPI_LOG_ERROR("Cannot open memory map %s", path);
+        return DPI_ERROR;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line_no++;
+
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+
+        char *p = line;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '\0' || *p == '\n' || *p == '\r') {
+            continue;
+        }
+
+        if (apb_model_parse_region(model, p) != DPI_SUCCESS) {
+            DPI_LOG_ERROR("  at %s:%d", path, line_no);
+            fclose(fp);
+            return DPI_ERROR;
+        }
+    }
+
+    fclose(fp);
+    DPI_LOG_INFO("Loaded %d regions from %s", model->num_regions, path);
+    return DPI_SUCCESS;
+}
+
+/**
+ * apb_model_find()
+ *
+ * Description:
+ *   Returns the region containing addr, or NULL (unmapped).
+ */
+static apb_region_t* apb_model_find(apb_model_t *model, uint64_t addr) {
+    apb_region_t *r = &model->regions[model->last_region];
+    if (model->num_regions > 0 && addr - r->base < r->size) {
+        return r;
+    }
+
+    for (int i = 0; i < model->num_regions; i++) {
+        r = &model->regions[i];
+        if (addr - r->base < r->size) {
+            model->last_region = i;
+            return r;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * apb_model_transfer()
+ *
+ * Description:
+ *   Executes one APB transfer against the memory map.
+ *
+ * Args:
+ *   req: Request record from Python (apb_request.h)
+ *   rsp: Output: read data, PSLVERR and cycle count
+ */
+void apb_model_transfer(apb_model_t *model, const apb_request_t *req, apb_response_t *rsp) {
+    uint64_t addr = req->addr & ~(uint64_t)3;
+    apb_region_t *region = apb_model_find(model, addr);
+
+    rsp->rdata = 0;
+    rsp->slverr = 0;
+    rsp->cycles = (uint32_t)req->delay + 2;
+
+    if (req->is_write) {
+        model->writes++;
+    } else {
+        model->reads++;
+    }
+
+    if (region == NULL) {
+        rsp->slverr = 1;
+        model->errors++;
+        model->cycles += rsp->cycles;
+        return;
+    }
+
+    region->accesses++;
+    rsp->cycles += region->wait_states;
+    model->cycles += rsp->cycles;
+
+    if (region->kind == APB_REGION_ERROR || (req->is_write && region->kind == APB_REGION_ROM)) {
+        rsp->slverr = 1;
+        model->errors++;
+        return;
+    }
+
+    uint8_t *word = region->mem + (addr - region->base);
+    if (req->is_write) {
+        for (int lane = 0; lane < 4; lane++) {
+            if (req->strobe & (1u << lane)) {
+                word[lane] = (uint8_t)(req->data >> (8 * lane));
+            }
+        }
+    } else {
+        rsp->rdata = (uint32_t)word[0] | (uint32_t)word[1] << 8 |
+                     (uint32_t)word[2] << 16 | (uint32_t)word[3] << 24;
+    }
+}
+
+/**
+ * apb_model_report()
+ *
+ * Description:
+ *   Prints the memory map with per-region access counts and the totals.
+ */
+void apb_model_report(const apb_model_t *model) {
+    DPI_LOG_INFO("APB model: %llu writes, %llu reads, %llu PSLVERR, %llu PCLK cycles",
+                 (unsigned long long)model->writes, (unsigned long long)model->reads,
+                 (unsigned long long)model->errors, (unsigned long long)model->cycles);
+
+    for (int i = 0; i < model->num_regions; i++) {
+        const apb_region_t *r = &model->regions[i];
+        DPI_LOG_INFO("  %-5s 0x%08llx-0x%08llx  wait=%u  accesses=%llu",
+                     region_kind_names[r->kind], (unsigned long long)r->base,
+                     (unsigned long long)(r->base + r->size - 1), r->wait_states,
+                     (unsigned long long)r->accesses);
+    }
+}
+
+/**
+ * apb_model_free()
+ *
+ * Description:
+ *   Releases region storage.
+ */
+void apb_model_free(apb_model_t *model) {
+    for (int i = 0; i < model->num_regions; i++) {
+        free(model->regions[i].mem);
+        model->regions[i].mem = NULL;
+    }
+    model->num_regions = 0;
+    model->last_region = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef APB_MODEL_H
+#define APB_MODEL_H
+
+#include <stdint.h>
+#include "../dpi_bridge/plugins/apb/apb_request.h"
+
+#define APB_MODEL_MAX_REGIONS 32
+
+// What a region of the memory map does
+typedef enum {
+    APB_REGION_RAM,     // Read/write storage
+    APB_REGION_ROM,     // Readable; writes get PSLVERR
+    APB_REGION_ERROR    // Every access gets PSLVERR
+} apb_region_kind_t;
+
+typedef struct {
+    apb_region_kind_t kind;
+    uint64_t base;
+    uint64_t size;          // Bytes
+    uint32_t wait_states;   // Extra access-phase cycles (PREADY low)
+    uint8_t *mem;           // Backing store (RAM/ROM only)
+    uint64_t accesses;
+} apb_region_t;
+
+// Transaction-level APB completer: one call = one complete transfer
+typedef struct {
+    apb_region_t regions[APB_MODEL_MAX_REGIONS];
+    int num_regions;
+    int last_region;        // Lookup cache: tests hit the same region in runs
+
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t errors;
+    uint64_t cycles;
+} apb_model_t;
+
+// Result of one transfer
+typedef struct {
+    uint32_t rdata;
+    int slverr;
+    uint32_t cycles;        // PCLK cycles from setup phase to PREADY
+} apb_response_t;
+
+// Memory map configuration
+void apb_model_init(apb_model_t *model);
+int apb_model_add_region(apb_model_t *model, apb_region_kind_t kind, uint64_t base,
+                         uint64_t size, uint32_t wait_states);
+int apb_model_parse_region(apb_model_t *model, const char *spec);
+int apb_model_load_map(apb_model_t *model, const char *path);
+
+// Execute one transfer
+void apb_model_transfer(apb_model_t *model, const apb_request_t *req, apb_response_t *rsp);
+
+void apb_model_report(const apb_model_t *model);
+void apb_model_free(apb_model_t *model);
+
+#endif // APB_MODEL_H
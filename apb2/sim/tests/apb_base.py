@@ -4,32 +4,113 @@ APB Base Classes and Utilities
 Provides reusable infrastructure for APB testing without test-specific stimulus.
 """
 
+from collections import deque
 from enum import IntEnum
 
+# Per-transaction log lines; off for throughput runs (apb_driver.set_verbose)
+verbose = True
+
 class APBTransactionType(IntEnum):
     """APB transaction types matching SystemVerilog apb_rd_wr_e enum"""
     READ = 0
     WRITE = 1
 
 
+class APBOpcode(IntEnum):
+    """Request opcodes matching APB_OP_* in apb_request.h"""
+    XFER = 0
+    WAIT_CLOCKS = 1
+    WAIT_RESET = 2
+    POLL = 3
+
+
+class APBOpStatus(IntEnum):
+    """Opcode completion status matching APB_OP_STATUS_* in apb_request.h"""
+    DONE = 0
+    TIMEOUT = 1
+    UNSUPPORTED = 2
+
+
+class APBRequestLayout:
+    """
+    Field order of the C/SV request record (apb_request.h)
+    
+    Set once by the C bridge through set_request_schema(). Each field name
+    becomes an attribute holding its index in the record, e.g. layout.addr.
+    The slot after the last field (layout.time) carries the simulation time
+    of the fill_request() call from C to Python.
+    """
+    
+    def __init__(self, fields):
+        """
+        Args:
+            fields: Tuple of (name, width) in record order
+        """
+        self.fields = tuple(fields)
+        for idx, (name, _width) in enumerate(self.fields):
+            setattr(self, name, idx)
+        self.time = len(self.fields)
+
+
 class APBTransaction:
     """Single APB transaction"""
     
-    def __init__(self, addr, data=0, is_write=True):
+    def __init__(self, addr, data=0, is_write=True, strobe=None, prot=1, delay=0, callback=None,
+                 op=APBOpcode.XFER, mask=0, timeout=0):
         """
         Create an APB transaction
         
         Args:
-            addr: 32-bit address
-            data: 32-bit data (for writes)
+            addr: Address (the record is 64 bits wide, the APB bus 32)
+            data: Data (for writes; the record is 64 bits wide, the APB bus 32)
             is_write: True for write, False for read
+            strobe: PSTRB byte lanes (default: all lanes for writes, 0 for reads)
+            prot: PPROT value (default 1, what the SV driver used to drive)
+            delay: Idle PCLK cycles before the transfer
+            callback: Optional function called with the read data (reads), or
+                      with (status, data) when an opcode finishes
+            op: APBOpcode; anything but XFER runs in SV without calling Python
+            mask: Compare mask (POLL)
+            timeout: Limit in cycles, 0 = none (WAIT_RESET, POLL)
         """
         self.addr = addr
         self.data = data
         self.is_write = is_write
         self.txn_type = APBTransactionType.WRITE if is_write else APBTransactionType.READ
+        self.strobe = strobe if strobe is not None else (0xF if is_write else 0)
+        self.prot = prot
+        self.delay = delay
+        self.callback = callback
+        self.op = op
+        self.mask = mask
+        self.timeout = timeout
+    
+    @property
+    def is_xfer(self):
+        """True for an APB transfer, False for an opcode run in SV"""
+        return self.op == APBOpcode.XFER
+    
+    def fill(self, rec, layout):
+        """
+        Write this transaction into a preallocated request record
+        
+        Args:
+            rec: memoryview of uint64 slots owned by the C bridge
+            layout: APBRequestLayout giving each field's slot
+        """
+        rec[layout.is_write] = int(self.txn_type)
+        rec[layout.addr] = self.addr
+        rec[layout.data] = self.data
+        rec[layout.strobe] = self.strobe
+        rec[layout.prot] = self.prot
+        rec[layout.delay] = self.delay
+        rec[layout.op] = int(self.op)
+        rec[layout.mask] = self.mask
+        rec[layout.timeout] = self.timeout
     
     def __repr__(self):
+        if not self.is_xfer:
+            return f"APBTransaction({self.op.name}, addr=0x{self.addr:X}, delay={self.delay})"
         txn_str = "Write" if self.is_write else "Read"
         return f"APBTransaction({txn_str}, addr=0x{self.addr:X}, data=0x{self.data:X})"
 
@@ -47,58 +128,160 @@ class APBSequence:
         self.name = name
         self.transactions = []
         self.current_idx = 0
-        self.read_data_callbacks = []
+        # Reads handed out but not yet answered, oldest first. Read data
+        # arrives in issue order, possibly after later transactions were
+        # generated (prefetch), so it is matched here, not by current_idx.
+        self.pending_reads = deque()
+        # Opcodes handed out but not yet finished, oldest first
+        self.pending_ops = deque()
     
-    def add_write(self, addr, data):
+    def add_write(self, addr, data, **fields):
         """
         Add a write transaction
         
         Args:
             addr: 32-bit address
             data: 32-bit data to write
+            fields: Optional strobe, prot, delay
             
         Returns:
             self (for method chaining)
         """
-        self.transactions.append(APBTransaction(addr, data, is_write=True))
+        self.transactions.append(APBTransaction(addr, data, is_write=True, **fields))
         return self
     
-    def add_read(self, addr, callback=None):
+    def add_read(self, addr, callback=None, **fields):
         """
         Add a read transaction
         
         Args:
             addr: 32-bit address
             callback: Optional function to call with read data
+            fields: Optional prot, delay
             
         Returns:
             self (for method chaining)
         """
-        self.transactions.append(APBTransaction(addr, 0, is_write=False))
-        self.read_data_callbacks.append(callback)
+        self.transactions.append(APBTransaction(addr, 0, is_write=False, callback=callback, **fields))
         return self
     
-    def get_next(self, sim_time):
+    def add_wait(self, cycles):
         """
-        Get next transaction for DPI bridge
+        Add an idle period, run in SV without calling Python
+        
+        Args:
+            cycles: Number of PCLK cycles to wait
+            
+        Returns:
+            self (for method chaining)
+        """
+        self.transactions.append(APBTransaction(0, is_write=False, strobe=0, delay=cycles,
+                                                op=APBOpcode.WAIT_CLOCKS))
+        return self
+    
+    def add_wait_reset(self, timeout=0, callback=None):
+        """
+        Add a wait for reset deassertion (PRESETn high), run in SV
+        
+        Args:
+            timeout: Maximum cycles to wait, 0 = no limit
+            callback: Optional function called with (status, data)
+            
+        Returns:
+            self (for method chaining)
+        """
+        self.transactions.append(APBTransaction(0, is_write=False, strobe=0, callback=callback,
+                                                op=APBOpcode.WAIT_RESET, timeout=timeout))
+        return self
+    
+    def add_poll(self, addr, value, mask=0xFFFFFFFF, timeout=0, interval=0, callback=None, **fields):
+        """
+        Add a register poll, run in SV: read `addr` until
+        (read data & mask) == (value & mask)
+        
+        Args:
+            addr: Address to read
+            value: Expected value
+            mask: Bits to compare
+            timeout: Maximum cycles to poll, 0 = no limit
+            interval: Idle cycles between reads
+            callback: Optional function called with (status, last read data)
+            fields: Optional prot
+            
+        Returns:
+            self (for method chaining)
+        """
+        self.transactions.append(APBTransaction(addr, value, is_write=False, callback=callback,
+                                                delay=interval, op=APBOpcode.POLL, mask=mask,
+                                                timeout=timeout, **fields))
+        return self
+    
+    def next_transaction(self, sim_time):
+        """
+        Advance to the next transaction and log it
         
         Args:
             sim_time: Current simulation time
             
         Returns:
-            Tuple of (is_write, addr, data) or None if no more transactions
+            APBTransaction or None if no more transactions
         """
         if self.current_idx < len(self.transactions):
             txn = self.transactions[self.current_idx]
             self.current_idx += 1
+            if not txn.is_xfer:
+                self.pending_ops.append(txn)
+                if verbose:
+                    print(f"[@{sim_time:>6}] [Python] Sending Opcode: {txn.op.name} Addr=0x{txn.addr:X}", flush=True)
+                return txn
+            if not txn.is_write:
+                self.pending_reads.append(txn)
             
-            txn_type_str = "Write" if txn.is_write else "Read"
-            print(f"[@{sim_time:>6}] [Python] Sending Transaction: {txn_type_str} Addr=0x{txn.addr:X} Data=0x{txn.data:X}", flush=True)
+            if verbose:
+                txn_type_str = "Write" if txn.is_write else "Read"
+                print(f"[@{sim_time:>6}] [Python] Sending Transaction: {txn_type_str} Addr=0x{txn.addr:X} Data=0x{txn.data:X}", flush=True)
             
-            return (int(txn.txn_type), txn.addr, txn.data)
+            return txn
         else:
             return None
     
+    def get_next(self, sim_time):
+        """
+        Get next transaction for DPI bridge
+        
+        Args:
+            sim_time: Current simulation time
+            
+        Returns:
+            Tuple of (is_write, addr, data) or None if no more transactions
+        """
+        txn = self.next_transaction(sim_time)
+        # The tuple interface carries transfers only: opcodes end at once
+        while txn is not None and not txn.is_xfer:
+            self.op_done(sim_time, APBOpStatus.UNSUPPORTED, 0)
+            txn = self.next_transaction(sim_time)
+        if txn is None:
+            return None
+        return (int(txn.txn_type), txn.addr, txn.data)
+    
+    def fill_next(self, sim_time, rec, layout):
+        """
+        Write next transaction into the C bridge's request record
+        
+        Args:
+            sim_time: Current simulation time
+            rec: Preallocated record (memoryview of uint64)
+            layout: APBRequestLayout
+            
+        Returns:
+            True if a transaction was written, False if none left
+        """
+        txn = self.next_transaction(sim_time)
+        if txn is None:
+            return False
+        txn.fill(rec, layout)
+        return True
+    
     def send_read_data(self, sim_time, data):
         """
         Receive read data from DPI bridge
@@ -107,18 +290,38 @@ class APBSequence:
             sim_time: Current simulation time
             data: 32-bit read data from APB bus
         """
-        print(f"[@{sim_time:>6}] [Python] Received Read Data: 0x{data:X}", flush=True)
+        if verbose:
+            print(f"[@{sim_time:>6}] [Python] Received Read Data: 0x{data:X}", flush=True)
         
-        # Call registered callback if any
-        read_idx = self.current_idx - 1  # Last transaction was the read
-        if 0 <= read_idx < len(self.read_data_callbacks):
-            callback = self.read_data_callbacks[read_idx]
-            if callback is not None:
-                callback(data)
+        # Call the callback registered with the oldest unanswered read, if any
+        if self.pending_reads:
+            txn = self.pending_reads.popleft()
+            if txn.callback is not None:
+                txn.callback(data)
+    
+    def op_done(self, sim_time, status, data):
+        """
+        Receive the completion of an opcode from DPI bridge
+        
+        Args:
+            sim_time: Current simulation time
+            status: APBOpStatus value
+            data: Last read data of a poll, 0 otherwise
+        """
+        status = APBOpStatus(status)
+        if not self.pending_ops:
+            return
+        txn = self.pending_ops.popleft()
+        if verbose:
+            print(f"[@{sim_time:>6}] [Python] Opcode {txn.op.name} finished: {status.name} Data=0x{data:X}", flush=True)
+        if txn.callback is not None:
+            txn.callback(status, data)
     
     def reset(self):
         """Reset sequence to beginning"""
         self.current_idx = 0
+        self.pending_reads.clear()
+        self.pending_ops.clear()
 
 
 class APBRandomSequence(APBSequence):
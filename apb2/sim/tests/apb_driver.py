@@ -7,27 +7,63 @@ Test stimulus is loaded from separate test files.
 
 import sys
 import os
+import importlib
 
 # Add tests directory to path
 sys.path.insert(0, os.path.join(os.path.dirname(__file__), 'tests'))
 
-from apb_base import APBSequence
+import apb_base
+from apb_base import APBSequence, APBRequestLayout
 
 # Global sequence - set by test
 current_sequence = None
 
+# Request record layout - set by C bridge at init
+request_layout = None
+
+# Modification time of each test module when it was (re)loaded
+_test_mtimes = {}
+
+# Set by reset(): load the default test on first use unless a test is loaded first
+_default_pending = False
+
+def _import_test(test_name):
+    """
+    Import a test module, reloading it in place if its file changed
+    
+    The interpreter persists across tests of a session, so a plain import
+    would keep serving the version loaded by the first test.
+    """
+    module = sys.modules.get(test_name)
+    if module is None:
+        module = importlib.import_module(test_name)
+    else:
+        path = getattr(module, '__file__', None)
+        if path is not None and os.path.getmtime(path) != _test_mtimes.get(test_name):
+            module = importlib.reload(module)
+            print(f"[Python] Reloaded changed test module: {test_name}", flush=True)
+    
+    path = getattr(module, '__file__', None)
+    if path is not None:
+        _test_mtimes[test_name] = os.path.getmtime(path)
+    return module
+
 def load_test(test_name):
     """
     Load test sequence from test module
     
     Args:
         test_name: Name of test module (e.g., 'apb_basic_test')
+        
+    Returns:
+        True if a sequence was loaded
     """
-    global current_sequence
+    global current_sequence, _default_pending
     
+    _default_pending = False
     try:
         # Import test module
-        test_module = __import__(test_name)
+        test_module = _import_test(test_name)
         
         # Get sequence from test
         if hasattr(test_module, 'create_sequence'):
@@ -39,6 +75,43 @@ def load_test(test_name):
     except ImportError as e:
         print(f"[Python] Error loading test '{test_name}': {e}", flush=True)
         current_sequence = None
+    
+    return current_sequence is not None
+
+def set_verbose(flag):
+    """
+    Turn the per-transaction log lines of APBSequence on or off
+    
+    Args:
+        flag: False for throughput runs (fast_sim --quiet)
+    """
+    apb_base.verbose = bool(flag)
+
+def default_test_name():
+    """Test selected by the APB_TEST environment variable"""
+    return os.environ.get('APB_TEST', 'apb_basic_test')
+
+def reset():
+    """
+    Called from C bridge between tests of a session
+    
+    Drops the current sequence. The next test either loads its own through
+    load_test() or gets a fresh sequence of the default test on first use,
+    as a newly started interpreter would.
+    
+    Returns:
+        True
+    """
+    global current_sequence, _default_pending
+    current_sequence = None
+    _default_pending = True
+    return True
+
+def _active_sequence():
+    """Current sequence, loading the default test first after a reset()"""
+    if _default_pending:
+        load_test(default_test_name())
+    return current_sequence
 
 # DPI-C callable functions
 def get_transaction(sim_time):
@@ -51,10 +124,38 @@ def get_transaction(sim_time):
     Returns:
         Tuple of (is_write, addr, data) or None
     """
-    if current_sequence is None:
+    sequence = _active_sequence()
+    if sequence is None:
         return None
     
-    return current_sequence.get_next(sim_time)
+    return sequence.get_next(sim_time)
+
+def set_request_schema(fields):
+    """
+    Called once from C bridge with the request record schema
+    
+    Args:
+        fields: Tuple of (name, width) in record order (apb_request.h)
+    """
+    global request_layout
+    request_layout = APBRequestLayout(fields)
+
+def fill_request(rec):
+    """
+    Called from C bridge to fill the next request record in place
+    
+    Args:
+        rec: Preallocated record (memoryview of uint64), reused every call;
+             rec[request_layout.time] holds the current simulation time
+        
+    Returns:
+        True if a request was written, False if none left
+    """
+    sequence = _active_sequence()
+    if sequence is None:
+        return False
+    
+    return sequence.fill_next(rec[request_layout.time], rec, request_layout)
 
 def send_read_data(sim_time, data):
     """
@@ -67,8 +168,19 @@ def send_read_data(sim_time, data):
     if current_sequence is not None:
         current_sequence.send_read_data(sim_time, data)
 
+def op_done(sim_time, status, data):
+    """
+    Called from C bridge when an opcode (wait, wait-for-reset, poll) finishes
+    
+    Args:
+        sim_time: Current simulation time
+        status: APB_OP_STATUS_* value (see APBOpStatus)
+        data: Last read data of a poll, 0 otherwise
+    """
+    if current_sequence is not None:
+        current_sequence.op_done(sim_time, status, data)
+
 # Auto-load default test if not loaded via DPI
 if current_sequence is None:
     # Check for TEST_NAME environment variable or plusarg
-    test_name = os.environ.get('APB_TEST', 'apb_basic_test')
-    load_test(test_name)
+    load_test(default_test_name())